@@ -0,0 +1,52 @@
+/**
+ * @file alloctracker.h
+ * @author Devin Arena
+ * @brief Optional counting of every allocation made through operator new, so
+ * the allocations of each phase of a frame can be measured (memory command,
+ * --trace).
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_ALLOCTRACKER_H
+#define TGRAPH_ALLOCTRACKER_H
+
+#include <cstdint>
+
+// compiling with allocation tracking on replaces the global operator new and
+// delete with counting versions, otherwise every count reads as zero
+
+// #define TG_ALLOC_TRACK
+
+// allocations a frame may make once the view is steady (same size, same
+// equations), frames over it are reported by the memory command
+#define ALLOC_FRAME_BUDGET 0
+
+struct AllocCount {
+  uint64_t allocations{0};
+  uint64_t bytes{0};
+};
+
+bool allocTracking();
+AllocCount threadAllocations();
+AllocCount totalAllocations();
+uint64_t liveAllocations();
+
+/**
+ * @brief Adds the allocations the calling thread makes during its lifetime
+ * to a total, e.g. one phase of a frame.
+ */
+class AllocMeter {
+ private:
+  AllocCount& total;
+  AllocCount start;
+
+ public:
+  AllocMeter(AllocCount& total) : total(total), start(threadAllocations()) {}
+  ~AllocMeter() {
+    AllocCount now = threadAllocations();
+    total.allocations += now.allocations - start.allocations;
+    total.bytes += now.bytes - start.bytes;
+  }
+};
+
+#endif
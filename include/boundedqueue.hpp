@@ -0,0 +1,97 @@
+/**
+ * @file boundedqueue.h
+ * @author Devin Arena
+ * @brief Lock-free bounded queue (Vyukov's array queue). Any number of threads
+ * may push and pop, and neither side ever blocks or takes a lock.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_BOUNDEDQUEUE_H
+#define TGRAPH_BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+template <typename T, size_t N>
+class BoundedQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+ private:
+  // a cell is free for the push at position p when its sequence is p, and
+  // holds the item for the pop at position p when its sequence is p + 1
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T item;
+  };
+  Cell cells[N];
+  // kept on separate cache lines so producers and consumers do not contend
+  alignas(64) std::atomic<size_t> tail;
+  alignas(64) std::atomic<size_t> head;
+
+ public:
+  BoundedQueue() : tail(0), head(0) {
+    for (size_t i = 0; i < N; i++) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Adds an item to the back of the queue.
+   *
+   * @param item T the item to add.
+   * @return bool false if the queue is full.
+   */
+  bool push(T item) {
+    Cell* cell;
+    size_t pos = tail.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells[pos & (N - 1)];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0) {
+        if (tail.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+    cell->item = std::move(item);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Takes the item at the front of the queue.
+   *
+   * @param item T& receives the item.
+   * @return bool false if the queue is empty.
+   */
+  bool pop(T& item) {
+    Cell* cell;
+    size_t pos = head.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells[pos & (N - 1)];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+      if (diff == 0) {
+        if (head.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head.load(std::memory_order_relaxed);
+      }
+    }
+    item = std::move(cell->item);
+    cell->sequence.store(pos + N, std::memory_order_release);
+    return true;
+  }
+};
+
+#endif
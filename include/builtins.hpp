@@ -1,4 +1,3 @@
-
 /**
  * @file builtins.h
  * @author Devin Arena
@@ -10,13 +9,12 @@
 #ifndef TGRAPH_BUILTINS_H
 #define TGRAPH_BUILTINS_H
 
+#include <climits>
 #include <cmath>
+#include <cstddef>
 #include <string>
 
-/**
- * @brief Define the builtin functions.
- */
-typedef double (*BuiltinFunc)(double);
+#include "opcodes.hpp"
 
 /**
  * @brief Builtin sin function, simply wraps over C++ sin.
@@ -88,55 +86,334 @@ static double tg_cot(double angle) {
 }
 
 /**
- * @brief Builtin sqrt function, simply wraps over C++ sqrt.
+ * @brief Builtin sqrt function, simply wraps over C++ sqrt (negative x is
+ * outside its domain).
  *
- * @param angle the angle to take the sqrt of.
- * @return double the sqrt of the angle.
+ * @param x the number to take the sqrt of.
+ * @return double the sqrt of x.
  */
 static double tg_sqrt(double x) {
-  if (x < 0)
-    return INT_MIN;
   return std::sqrt(x);
 }
 
 /**
- * @brief Builtin natural logarithm, uses change of base formula.
+ * @brief Builtin natural logarithm (x <= 0 is outside its domain).
  *
  * @param x the number to take the natural logarithm of
  * @return double the natural logarithm
  */
 static double tg_ln(double x) {
-  if (x <= 0)
-    return INT_MIN;
-  return std::log(x) / std::log(M_E);
+  return std::log(x);
 }
 
 /**
- * @brief Resolves the builtin function name to the function pointer.
+ * @brief Builtin base 10 logarithm (x <= 0 is outside its domain).
  *
- * @param fname the name of the function.
- * @return BuiltinFunc the function pointer.
- */
-static inline BuiltinFunc resolveFunction(std::string fname) {
-  if (fname == "sin") {
-    return &tg_sin;
-  } else if (fname == "cos") {
-    return &tg_cos;
-  } else if (fname == "tan") {
-    return &tg_tan;
-  } else if (fname == "sec") {
-    return &tg_sec;
-  } else if (fname == "csc") {
-    return &tg_csc;
-  } else if (fname == "cot") {
-    return &tg_cot;
-  } else if (fname == "sqrt") {
-    return &tg_sqrt;
-  } else if (fname == "ln") {
-    return &tg_ln;
-  } else {
+ * @param x the number to take the logarithm of.
+ * @return double the base 10 logarithm.
+ */
+static double tg_log10(double x) {
+  return std::log10(x);
+}
+
+/**
+ * @brief Builtin exponential function, e to the power of x.
+ *
+ * @param x the exponent.
+ * @return double e^x.
+ */
+static double tg_exp(double x) {
+  return std::exp(x);
+}
+
+/**
+ * @brief Builtin absolute value.
+ *
+ * @param x the number.
+ * @return double the magnitude of x.
+ */
+static double tg_abs(double x) {
+  return std::fabs(x);
+}
+
+/**
+ * @brief Builtin floor function.
+ *
+ * @param x the number to round down.
+ * @return double the largest integer not above x.
+ */
+static double tg_floor(double x) {
+  return std::floor(x);
+}
+
+/**
+ * @brief Builtin inverse sine (|x| > 1 is outside its domain).
+ *
+ * @param x the sine of the angle.
+ * @return double the angle, between -pi/2 and pi/2.
+ */
+static double tg_asin(double x) {
+  return std::asin(x);
+}
+
+/**
+ * @brief Builtin inverse cosine (|x| > 1 is outside its domain).
+ *
+ * @param x the cosine of the angle.
+ * @return double the angle, between 0 and pi.
+ */
+static double tg_acos(double x) {
+  return std::acos(x);
+}
+
+/**
+ * @brief Builtin inverse tangent.
+ *
+ * @param x the tangent of the angle.
+ * @return double the angle, between -pi/2 and pi/2.
+ */
+static double tg_atan(double x) {
+  return std::atan(x);
+}
+
+/**
+ * @brief Builtin hyperbolic sine.
+ *
+ * @param x the number.
+ * @return double sinh(x).
+ */
+static double tg_sinh(double x) {
+  return std::sinh(x);
+}
+
+/**
+ * @brief Builtin hyperbolic cosine.
+ *
+ * @param x the number.
+ * @return double cosh(x).
+ */
+static double tg_cosh(double x) {
+  return std::cosh(x);
+}
+
+/**
+ * @brief Builtin hyperbolic tangent.
+ *
+ * @param x the number.
+ * @return double tanh(x).
+ */
+static double tg_tanh(double x) {
+  return std::tanh(x);
+}
+
+/**
+ * @brief Builtin minimum of two values.
+ *
+ * @param a the first value.
+ * @param b the second value.
+ * @return double the smaller value.
+ */
+static double tg_min(double a, double b) {
+  return b < a ? b : a;
+}
+
+/**
+ * @brief Builtin maximum of two values.
+ *
+ * @param a the first value.
+ * @param b the second value.
+ * @return double the larger value.
+ */
+static double tg_max(double a, double b) {
+  return b > a ? b : a;
+}
+
+/**
+ * @brief Builtin two argument inverse tangent, the angle of the point (x, y).
+ *
+ * @param y the y coordinate.
+ * @param x the x coordinate.
+ * @return double the angle, between -pi and pi.
+ */
+static double tg_atan2(double y, double x) {
+  return std::atan2(y, x);
+}
+
+/**
+ * @brief Builtin clamp, limits a value to a range.
+ *
+ * @param v the value.
+ * @param lo the lowest value returned.
+ * @param hi the highest value returned.
+ * @return double v limited to [lo, hi].
+ */
+static double tg_clamp(double v, double lo, double hi) {
+  v = v < lo ? lo : v;
+  return v > hi ? hi : v;
+}
+
+// the arguments a builtin is defined for, it gives INT_MIN for the others
+enum class Domain { ALL, NON_NEGATIVE, POSITIVE, UNIT };
+
+/**
+ * @brief Checks if an argument is in a domain.
+ *
+ * @param domain Domain the domain.
+ * @param x double the argument.
+ * @return bool true if the builtin is defined at x.
+ */
+static constexpr bool inDomain(Domain domain, double x) {
+  switch (domain) {
+    case Domain::NON_NEGATIVE:
+      return x >= 0;
+    case Domain::POSITIVE:
+      return x > 0;
+    case Domain::UNIT:
+      return x >= -1 && x <= 1;
+    default:
+      return true;
+  }
+}
+
+// Scalar and vector implementations of the builtins, instantiated for each
+// function so the function is inlined into the loop over the lanes (and the
+// loop vectorized where the function allows it). The first argument's lanes
+// receive the results.
+
+template <double (*F)(double), Domain D>
+static double scalar1(const double* args) {
+  return inDomain(D, args[0]) ? F(args[0]) : INT_MIN;
+}
+
+template <double (*F)(double), Domain D>
+static void vector1(double* const* args, size_t n) {
+  double* a = args[0];
+  for (size_t k = 0; k < n; k++)
+    a[k] = inDomain(D, a[k]) ? F(a[k]) : INT_MIN;
+}
+
+template <double (*F)(double, double)>
+static double scalar2(const double* args) {
+  return F(args[0], args[1]);
+}
+
+template <double (*F)(double, double)>
+static void vector2(double* const* args, size_t n) {
+  double* a = args[0];
+  const double* b = args[1];
+  for (size_t k = 0; k < n; k++)
+    a[k] = F(a[k], b[k]);
+}
+
+template <double (*F)(double, double, double)>
+static double scalar3(const double* args) {
+  return F(args[0], args[1], args[2]);
+}
+
+template <double (*F)(double, double, double)>
+static void vector3(double* const* args, size_t n) {
+  double* a = args[0];
+  const double* b = args[1];
+  const double* c = args[2];
+  for (size_t k = 0; k < n; k++)
+    a[k] = F(a[k], b[k], c[k]);
+}
+
+/**
+ * @brief A builtin function, compiled to its own opcode which pops arity
+ * arguments and pushes the result.
+ */
+struct Builtin {
+  const char* name;
+  int arity;
+  OP opcode;
+  Domain domain;
+  double (*scalar)(const double* args);
+  void (*vector)(double* const* args, size_t n);
+};
+
+#define TG_UNARY(name, op, fn, domain)                              \
+  {name, 1, OP::op, Domain::domain, &scalar1<fn, Domain::domain>, \
+   &vector1<fn, Domain::domain>}
+#define TG_BINARY(name, op, fn) \
+  {name, 2, OP::op, Domain::ALL, &scalar2<fn>, &vector2<fn>}
+#define TG_TERNARY(name, op, fn) \
+  {name, 3, OP::op, Domain::ALL, &scalar3<fn>, &vector3<fn>}
+
+// every builtin, in the order of their opcodes from OP::ABS
+static constexpr Builtin BUILTINS[] = {
+    TG_UNARY("abs", ABS, tg_abs, ALL),
+    TG_BINARY("min", MIN, tg_min),
+    TG_BINARY("max", MAX, tg_max),
+    TG_TERNARY("clamp", CLAMP, tg_clamp),
+    TG_UNARY("sin", SIN, tg_sin, ALL),
+    TG_UNARY("cos", COS, tg_cos, ALL),
+    TG_UNARY("tan", TAN, tg_tan, ALL),
+    TG_UNARY("sec", SEC, tg_sec, ALL),
+    TG_UNARY("csc", CSC, tg_csc, ALL),
+    TG_UNARY("cot", COT, tg_cot, ALL),
+    TG_UNARY("sqrt", SQRT, tg_sqrt, NON_NEGATIVE),
+    TG_UNARY("ln", LN, tg_ln, POSITIVE),
+    TG_UNARY("log10", LOG10, tg_log10, POSITIVE),
+    TG_UNARY("exp", EXP, tg_exp, ALL),
+    TG_UNARY("floor", FLOOR, tg_floor, ALL),
+    TG_UNARY("asin", ASIN, tg_asin, UNIT),
+    TG_UNARY("acos", ACOS, tg_acos, UNIT),
+    TG_UNARY("atan", ATAN, tg_atan, ALL),
+    TG_UNARY("sinh", SINH, tg_sinh, ALL),
+    TG_UNARY("cosh", COSH, tg_cosh, ALL),
+    TG_UNARY("tanh", TANH, tg_tanh, ALL),
+    TG_BINARY("atan2", ATAN2, tg_atan2),
+};
+
+#undef TG_UNARY
+#undef TG_BINARY
+#undef TG_TERNARY
+
+/**
+ * @brief Checks that BUILTINS lists every builtin opcode in order, so an
+ * opcode can index it.
+ *
+ * @return bool true if it does.
+ */
+static constexpr bool builtinsInOrder() {
+  size_t count = sizeof(BUILTINS) / sizeof(Builtin);
+  if (count != (size_t)(+OP::END - +OP::ABS))
+    return false;
+  for (size_t i = 0; i < count; i++) {
+    if (+BUILTINS[i].opcode != +OP::ABS + (int)i)
+      return false;
+  }
+  return true;
+}
+
+static_assert(builtinsInOrder(),
+              "BUILTINS must list the builtin opcodes in order");
+
+/**
+ * @brief Gets the builtin function an opcode applies.
+ *
+ * @param op OP the opcode.
+ * @return const Builtin* the builtin, or nullptr if op is not a builtin.
+ */
+static constexpr const Builtin* builtin(OP op) {
+  if (+op < +OP::ABS || +op >= +OP::END)
     return nullptr;
+  return &BUILTINS[+op - +OP::ABS];
+}
+
+/**
+ * @brief Resolves the builtin function name to its entry in BUILTINS.
+ *
+ * @param fname the name of the function.
+ * @return const Builtin* the builtin, or nullptr if there is none.
+ */
+static inline const Builtin* resolveFunction(const std::string& fname) {
+  for (const Builtin& function : BUILTINS) {
+    if (fname == function.name)
+      return &function;
   }
+  return nullptr;
 }
 
 /**
@@ -155,4 +432,4 @@ static inline double resolveConstant(std::string cname) {
   }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file curve.h
+ * @author Devin Arena
+ * @brief Parametric curves (x(t), y(t)) and polar curves r(theta), sampled
+ * more densely where they cover more of the screen.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_CURVE_H
+#define TGRAPH_CURVE_H
+
+#include <string>
+#include <vector>
+
+#include "environment.hpp"
+#include "vm.hpp"
+
+// parameter values of the first, uniform pass over the range
+#define CURVE_COARSE 256
+// most samples a segment of the first pass is split into, and the number for
+// a segment with an undefined end
+#define CURVE_MAX_SPLIT 256
+#define CURVE_UNDEFINED_SPLIT 8
+// dots of screen-space arc length between samples, and the furthest apart two
+// samples are joined by a line (further apart they are a jump, e.g. across an
+// asymptote)
+#define CURVE_SPACING 0.5
+#define CURVE_JOIN 4
+
+union Operand;
+
+enum class CurveKind { PARAMETRIC, POLAR };
+
+class Curve {
+ private:
+  CurveKind kind;
+  std::string expression;
+  // computes x then y (parametric) or r (polar) of the parameter, loaded by
+  // VAR
+  std::vector<Operand> program;
+  // user-definable names the expression depends on
+  std::vector<std::string> deps;
+  double t0, t1;
+  // sampled parameter values and their positions in dots (column, row
+  // pairs), NaN where the curve is undefined
+  std::vector<double> ts;
+  std::vector<double> points;
+  std::vector<double> out;
+  VM vm;
+  void evaluate(double left, double top, double scaleX, double scaleY);
+  int splits(size_t segment, int columns, int rows) const;
+
+ public:
+  Curve(CurveKind kind, const std::string& expression, const Environment* env);
+  void setProgram(const std::vector<Operand>& program,
+                  const std::vector<std::string>& deps,
+                  double t0,
+                  double t1);
+  void sample(double left,
+              double top,
+              double scaleX,
+              double scaleY,
+              int columns,
+              int rows);
+  CurveKind getKind() const;
+  const std::string& getExpression() const;
+  const std::vector<std::string>& getDeps() const;
+  const std::vector<double>& getPoints() const;
+  size_t footprint() const;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file dataset.h
+ * @author Devin Arena
+ * @brief Large x,y datasets plotted next to the equations. Points are memory
+ * mapped and summarized by a min/max pyramid so a column of the screen costs
+ * the same no matter how many points it covers.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_DATASET_H
+#define TGRAPH_DATASET_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// points summarized by each entry of the lowest pyramid level
+#define DATA_BLOCK 256
+
+class Dataset {
+ private:
+  std::string name;
+  // x,y pairs sorted by x, mapped from a file
+  const double* points;
+  size_t count;
+  void* mapping;
+  size_t mappedBytes;
+  // points read into memory on platforms without mmap
+  std::vector<double> fallback;
+  // min and max y of each block, level 0 has one entry per DATA_BLOCK points
+  // and every level above combines pairs of the level below
+  std::vector<std::vector<double>> lows;
+  std::vector<std::vector<double>> highs;
+  bool map(FILE* file);
+  FILE* convertCSV(const std::string& path);
+  bool buildPyramid();
+  size_t lowerBound(double x) const;
+  void rangeMinMax(size_t first, size_t last, double& low, double& high) const;
+
+ public:
+  Dataset();
+  ~Dataset();
+  Dataset(const Dataset&) = delete;
+  Dataset& operator=(const Dataset&) = delete;
+  bool load(const std::string& path);
+  void columns(double left,
+               double step,
+               int width,
+               double* low,
+               double* high) const;
+  const std::string& getName() const;
+  size_t size() const;
+  size_t footprint() const;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file environment.h
+ * @author Devin Arena
+ * @brief Stores user definitions (parameters and functions) made with let.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_ENVIRONMENT_H
+#define TGRAPH_ENVIRONMENT_H
+
+#include <string>
+#include <vector>
+
+// Kinds of user definitions
+enum class SymbolKind {
+  PARAM,  // e.g. let a = 3
+  FUNC,   // e.g. let g(t) = t^2 + a
+};
+
+/**
+ * @brief A single user definition. Parameters store their current value and
+ * the body it was evaluated from, functions store their argument name and
+ * body source so they can be inlined at compile time.
+ */
+struct Symbol {
+  std::string name;
+  SymbolKind kind;
+  double value;
+  std::string arg;
+  std::string body;
+  // names the body of a parameter references, it is re-evaluated when they
+  // change
+  std::vector<std::string> deps;
+};
+
+class Environment {
+ private:
+  std::vector<Symbol> symbols;
+  // parameter values indexed by symbol index, read directly by the VM
+  std::vector<double> values;
+
+ public:
+  Environment();
+  int resolve(const std::string& name) const;
+  int defineParam(const std::string& name,
+                  double value,
+                  const std::string& body = "",
+                  const std::vector<std::string>& deps = {});
+  int defineFunction(const std::string& name,
+                     const std::string& arg,
+                     const std::string& body);
+  const Symbol& get(int index) const;
+  const double* getValues() const;
+  size_t size() const;
+};
+
+#endif
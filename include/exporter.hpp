@@ -0,0 +1,46 @@
+/**
+ * @file exporter.h
+ * @author Devin Arena
+ * @brief Streams high resolution samples of a program to CSV or raw float64
+ * files using constant memory.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_EXPORTER_H
+#define TGRAPH_EXPORTER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "vm.hpp"
+
+union Operand;
+
+class Exporter {
+ private:
+  VM& vm;
+  size_t sampleBatch(const std::vector<Operand>& program,
+                     double x0,
+                     double x1,
+                     size_t n,
+                     size_t first,
+                     size_t count,
+                     double* xs,
+                     double* ys);
+
+ public:
+  Exporter(VM& vm);
+  bool writeCSV(const std::vector<Operand>& program,
+                double x0,
+                double x1,
+                size_t n,
+                const std::string& filename);
+  bool writeF64(const std::vector<Operand>& program,
+                double x0,
+                double x1,
+                size_t n,
+                const std::string& filename);
+};
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file field.h
+ * @author Devin Arena
+ * @brief Expressions of x and y evaluated over the whole view, drawn as the
+ * contour where they are zero (implicit plots) or shaded by value (heat maps).
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_FIELD_H
+#define TGRAPH_FIELD_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "environment.hpp"
+#include "vm.hpp"
+
+// width and height of the tiles a field is evaluated in, a tile of values
+// (8 KiB) stays in the L1 cache of the worker evaluating it
+#define FIELD_TILE_W 64
+#define FIELD_TILE_H 16
+
+// glyphs shading a heat map, from the lowest value to the highest
+#define FIELD_SHADES " .:-=+*#%@"
+
+union Operand;
+
+enum class FieldKind { IMPLICIT, HEAT };
+
+class Field {
+ private:
+  FieldKind kind;
+  std::string expression;
+  std::vector<Operand> program;
+  // user-definable names the expression depends on
+  std::vector<std::string> deps;
+  // values on the sampled grid (row major) and the range of the valid ones
+  std::vector<double> values;
+  int columns, rows;
+  double low, high;
+  // a VM and a result buffer per worker
+  std::vector<VM> vms;
+  std::vector<std::vector<double>> outs;
+  double value(int column, int row) const;
+
+ public:
+  Field(FieldKind kind, const std::string& expression, const Environment* env);
+  void setProgram(const std::vector<Operand>& program,
+                  const std::vector<std::string>& deps);
+  bool sample(double left,
+              double top,
+              double stepX,
+              double stepY,
+              int columns,
+              int rows,
+              const std::function<bool()>& cancelled);
+  int crossing(int column, int row) const;
+  char shade(int column, int row) const;
+  static char contourGlyph(int crossing);
+  FieldKind getKind() const;
+  const std::string& getExpression() const;
+  const std::vector<std::string>& getDeps() const;
+  size_t footprint() const;
+};
+
+#endif
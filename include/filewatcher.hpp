@@ -0,0 +1,40 @@
+/**
+ * @file filewatcher.h
+ * @author Devin Arena
+ * @brief Notices when a file is written, with inotify where available and by
+ * polling its modification time elsewhere.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_FILEWATCHER_H
+#define TGRAPH_FILEWATCHER_H
+
+#include <string>
+
+class FileWatcher {
+ private:
+  std::string path;
+  // the name of the file in its directory, inotify watches the directory so
+  // a file replaced by a rename (as many editors save) is still seen
+  std::string name;
+  // the inotify instance and watch, -1 when polling
+  int fd;
+  int watch;
+  // modification time and size at the last check, when polling
+  long long mtime;
+  long long size;
+  bool stamp(long long& mtime, long long& size) const;
+
+ public:
+  FileWatcher();
+  ~FileWatcher();
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+  bool open(const std::string& path);
+  void close();
+  bool changed();
+  bool isOpen() const;
+  const std::string& getPath() const;
+};
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file libtgraph.h
+ * @author Devin Arena
+ * @brief Stable C API of libtgraph, for compiling and evaluating TGraph
+ * expressions in other processes without starting the CLI.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_LIBTGRAPH_H
+#define TGRAPH_LIBTGRAPH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief An opaque compiled expression. Handles are immutable once compiled,
+ * so one handle may be evaluated from several threads at once.
+ */
+typedef struct tg_program tg_program;
+
+/**
+ * @brief Compiles an expression of x, e.g. "e ^ sin(x)".
+ *
+ * @param expression const char* the expression.
+ * @return tg_program* the compiled expression, or NULL on a syntax error.
+ */
+tg_program* tg_compile(const char* expression);
+
+/**
+ * @brief Gets the number of values the expression produces per x (more than
+ * one when it uses +/-).
+ *
+ * @param program const tg_program* the compiled expression.
+ * @return size_t the number of values per x.
+ */
+size_t tg_results(const tg_program* program);
+
+/**
+ * @brief Evaluates an expression over an array of x values. Strides are in
+ * elements, the values for xs[i * xstride] are written starting at
+ * ys[i * ystride], so ystride must be at least tg_results(program).
+ *
+ * @param program const tg_program* the compiled expression.
+ * @param xs const double* the x values.
+ * @param xstride size_t the stride between x values.
+ * @param ys double* receives the results.
+ * @param ystride size_t the stride between result rows.
+ * @param n size_t the number of x values.
+ * @return int 0 on success, -1 on invalid arguments.
+ */
+int tg_eval(const tg_program* program,
+            const double* xs,
+            size_t xstride,
+            double* ys,
+            size_t ystride,
+            size_t n);
+
+/**
+ * @brief Renders expressions into a caller provided character buffer exactly
+ * like the terminal graph (without its header text), width * height chars in
+ * row-major order with no line breaks or terminator. The view is centred on
+ * (0, 0), see tg_render_view for other views.
+ *
+ * @param programs const tg_program* const* the compiled expressions.
+ * @param count size_t the number of expressions.
+ * @param xstep double the x distance between columns.
+ * @param ystep double the y distance between rows.
+ * @param buffer char* receives the rendered graph.
+ * @param width int the width of the graph in characters.
+ * @param height int the height of the graph in characters.
+ * @return int 0 on success, -1 on invalid arguments, including steps that
+ * are zero or not finite.
+ */
+int tg_render(const tg_program* const* programs,
+              size_t count,
+              double xstep,
+              double ystep,
+              char* buffer,
+              int width,
+              int height);
+
+/**
+ * @brief Renders expressions like tg_render, into a view centred on
+ * (originx, originy).
+ *
+ * @param programs const tg_program* const* the compiled expressions.
+ * @param count size_t the number of expressions.
+ * @param xstep double the x distance between columns.
+ * @param ystep double the y distance between rows.
+ * @param originx double the x value at the middle column.
+ * @param originy double the y value at the middle row.
+ * @param buffer char* receives the rendered graph.
+ * @param width int the width of the graph in characters.
+ * @param height int the height of the graph in characters.
+ * @return int 0 on success, -1 on invalid arguments, including steps that
+ * are zero or not finite.
+ */
+int tg_render_view(const tg_program* const* programs,
+                   size_t count,
+                   double xstep,
+                   double ystep,
+                   double originx,
+                   double originy,
+                   char* buffer,
+                   int width,
+                   int height);
+
+/**
+ * @brief Frees a compiled expression.
+ *
+ * @param program tg_program* the compiled expression, may be NULL.
+ */
+void tg_free(tg_program* program);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
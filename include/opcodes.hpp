@@ -0,0 +1,51 @@
+/**
+ * @file opcodes.h
+ * @author Devin Arena
+ * @brief The instruction set shared by the parser, optimizer and VM.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_OPCODES_H
+#define TGRAPH_OPCODES_H
+
+#include <type_traits>
+
+// compiling with debug on prints out opcodes as the program runs
+
+// #define TG_DEBUG
+
+// Helper macros for creating Operand unions.
+#define OPCODE(op) ((Operand){.opcode = op})
+#define VALUE(val) ((Operand){.value = val})
+#define INDEX(i) ((Operand){.index = i})
+
+// Opcodes for the instruction set, opcodes are generated by the Pratt parser
+// and interpreted by the VM.
+// Comparisons push 1 or 0, SELECT picks its second or third operand by its
+// first without branching.
+// POLY is followed by the number of numerator and denominator coefficients,
+// then the coefficients highest degree first, and pushes their ratio at x (no
+// denominator coefficients for a plain polynomial).
+// VAR_Y pushes y, which is only given when evaluating a field f(x, y).
+// The opcodes from ABS up to END apply the builtin functions, see BUILTINS
+// in builtins.hpp (arguments are pushed first to last).
+enum class OP { VAR, CONST, PARAM, NEG, ADD, SUB, MUL, DIV, POW, PLUS_OR_MINUS, MAGIC, CACHED,
+                LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL, SELECT, POLY, VAR_Y,
+                ABS, MIN, MAX, CLAMP, SIN, COS, TAN, SEC, CSC, COT, SQRT, LN, LOG10, EXP, FLOOR,
+                ASIN, ACOS, ATAN, SINH, COSH, TANH, ATAN2, END };
+
+// overload operator for +(enum class) to give its ordinum
+template <typename T>
+constexpr auto operator+(T e) noexcept
+    -> std::enable_if_t<std::is_enum<T>::value, std::underlying_type_t<T>> {
+  return static_cast<std::underlying_type_t<T>>(e);
+}
+
+// Operand union for the instruction set.
+union Operand {
+  OP opcode;
+  double value;
+  int index;
+};
+
+#endif
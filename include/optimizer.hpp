@@ -0,0 +1,57 @@
+/**
+ * @file optimizer.h
+ * @author Devin Arena
+ * @brief Rewrites compiled programs, e.g. hoisting subexpressions that do not
+ * change during an animation out of the frame loop or evaluating polynomials
+ * by Horner's rule.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_OPTIMIZER_H
+#define TGRAPH_OPTIMIZER_H
+
+#include <vector>
+
+// highest degree of a polynomial compiled to a POLY opcode
+#define POLY_MAX_DEGREE 32
+
+union Operand;
+enum class OP;
+
+class Optimizer {
+ private:
+  /**
+   * @brief A value on the symbolic stack, the opcodes that compute it and
+   * whether it changes with the animated parameter.
+   */
+  struct Entry {
+    std::vector<Operand> code;
+    bool variant;
+  };
+  /**
+   * @brief A value on the symbolic stack of the polynomial pass. If it is a
+   * polynomial in x, or a ratio of two, the coefficients are kept lowest
+   * degree first (den is empty for a polynomial). Otherwise only the opcodes
+   * computing it are known, which may be none if an earlier entry's opcodes
+   * push it too (as +/- does).
+   */
+  struct Term {
+    std::vector<Operand> code;
+    std::vector<double> num;
+    std::vector<double> den;
+    bool polynomial;
+  };
+  std::vector<Operand> materialize(Entry& entry,
+                                   std::vector<std::vector<Operand>>& hoisted);
+  std::vector<Operand> materialize(Term& term);
+  bool combine(OP op, Term& a, const Term& b);
+
+ public:
+  Optimizer();
+  std::vector<Operand> hoist(std::vector<Operand>& program,
+                             int param,
+                             std::vector<std::vector<Operand>>& hoisted);
+  std::vector<Operand> polynomials(const std::vector<Operand>& program);
+};
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ * @file pane.h
+ * @author Devin Arena
+ * @brief Viewports sharing the terminal when it is split, each with its own
+ * view, equation subset and sample caches.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_PANE_H
+#define TGRAPH_PANE_H
+
+#include <cstddef>
+#include <vector>
+
+// smallest pane a split may leave, in cells
+#define PANE_MIN_WIDTH 16
+#define PANE_MIN_HEIGHT 8
+
+// the view of a pane, loaded into TGraph while the pane is drawn or edited
+struct View {
+  int screenWidth{0};
+  int screenHeight{0};
+  double stepX{1.0};
+  double stepY{1.0};
+  double originX{0.0};
+  double originY{0.0};
+  // cached y values of each equation (one row of results per column of dots)
+  std::vector<std::vector<double>> samples;
+  std::vector<size_t> strides;
+  // whether each equation is shown, equations past the end are shown
+  std::vector<char> shown;
+};
+
+struct Pane {
+  // the part of the terminal covered, as fractions so the layout follows
+  // resizes, and the first column and row of cells it covers
+  double x0{0.0}, y0{0.0}, x1{1.0}, y1{1.0};
+  int left{0};
+  int top{0};
+  View view;
+};
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file parallel.h
+ * @author Devin Arena
+ * @brief Helpers for spreading work across threads.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_PARALLEL_H
+#define TGRAPH_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tracer.hpp"
+
+/**
+ * @brief Gets the number of worker threads to use.
+ *
+ * @return unsigned the number of hardware threads, at least 1.
+ */
+static inline unsigned workerCount() {
+  unsigned n = std::thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+/**
+ * @brief Runs fn(worker, index) for every index in [0, count). Workers pull
+ * the next index from a shared counter so uneven work balances itself, and
+ * the worker number (below workerCount()) lets callers keep per-thread state.
+ * Each index is traced as a task when tracing.
+ *
+ * @param count size_t the number of indices.
+ * @param fn Func the work to run for each index.
+ */
+template <typename Func>
+void parallelFor(size_t count, Func fn) {
+  std::atomic<size_t> next{0};
+  unsigned workers = std::min<size_t>(workerCount(), count);
+  auto work = [&](unsigned worker) {
+    if (worker > 0)
+      Tracer::instance().nameThread("worker " + std::to_string(worker));
+    for (size_t i = next++; i < count; i = next++) {
+      TG_TRACE("task", i);
+      fn(worker, i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned w = 1; w < workers; w++) {
+    threads.emplace_back(work, w);
+  }
+  if (workers > 0)
+    work(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+#endif
@@ -9,6 +9,7 @@
 #ifndef TGRAPH_PARSER_H
 #define TGRAPH_PARSER_H
 
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,8 @@ enum class OP;
 // Pratt Parser precedence table
 enum class Precedence {
   NONE,
+  TERNARY,
+  COMPARISON,
   TERM,
   FACTOR,
   POWER,
@@ -45,6 +48,14 @@ class Parser {
   std::vector<Token> tokens;
   size_t tindex;
   ParseRule parseRules[(int)TType::END];
+  const Environment* env;
+  // scans user function bodies as they are inlined
+  Scanner scanner;
+  // compiled arguments of the user functions currently being inlined
+  std::vector<std::vector<Operand>> args;
+  // user-definable names the last parse depended on
+  std::vector<std::string> names;
+  bool error;
 
   Token currentToken();
   Token prevToken();
@@ -53,15 +64,24 @@ class Parser {
   void func();
   void grouping();
   void binary();
+  void ternary();
   void unary();
   void variable();
   void literal();
+  void param();
+  void call();
+  void argument();
 
  public:
-  Parser();
-  std::vector<Operand> parse(std::vector<Token>& tokens);
-  void printOPs(std::vector<Operand>& ops);
-  int printOP(std::vector<Operand>& ops, int op);
+  Parser(const Environment* env = nullptr);
+  std::vector<Operand> parse(std::vector<Token>& tokens,
+                             const std::vector<Operand>* argument = nullptr);
+  const std::vector<std::string>& getNames() const;
+  bool hadError() const;
+  void printOPs(std::vector<Operand>& ops, std::ostream& stream = std::cout);
+  int printOP(std::vector<Operand>& ops,
+              int op,
+              std::ostream& stream = std::cout);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,253 @@
+/**
+ * @file plot.h
+ * @author Devin Arena
+ * @brief Conventions for plotting equations onto a character grid, shared by
+ * the terminal view and the C API so both produce the same output.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_PLOT_H
+#define TGRAPH_PLOT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Gets the symbol an equation is plotted with.
+ *
+ * @param equation int the index of the equation.
+ * @return char the symbol, x for the first equation, then y, z, a, ...
+ */
+static inline char plotSymbol(int equation) {
+  return 'a' + (23 + equation) % 26;
+}
+
+/**
+ * @brief Gets the x value at the centre of a column.
+ *
+ * @param column int the column.
+ * @param width int the width of the grid.
+ * @param stepX double the x distance between columns.
+ * @param originX double the x value at the middle column.
+ * @return double the x value.
+ */
+static inline double plotX(int column,
+                           int width,
+                           double stepX,
+                           double originX = 0) {
+  return originX + (column - width / 2) * stepX;
+}
+
+/**
+ * @brief Gets the row a y value is plotted on.
+ *
+ * @param y double the y value.
+ * @param height int the height of the grid.
+ * @param stepY double the y distance between rows.
+ * @param originY double the y value at the middle row.
+ * @return int the row, or -1 if it is off the grid (or undefined).
+ */
+static inline int plotRow(double y,
+                          int height,
+                          double stepY,
+                          double originY = 0) {
+  double row = std::round(height / 2 - (y - originY) / stepY);
+  if (!(row > 0 && row < height))
+    return -1;
+  return (int)row;
+}
+
+/**
+ * @brief Gets the row a y value is plotted on, clamped to just past the edges
+ * of the grid (0 or height) so a vertical span reaching off the grid is still
+ * drawn up to its edge.
+ *
+ * @param y double the y value, must not be NaN.
+ * @param height int the height of the grid.
+ * @param stepY double the y distance between rows.
+ * @param originY double the y value at the middle row.
+ * @return int the row, between 0 and height.
+ */
+static inline int plotRowClamped(double y,
+                                 int height,
+                                 double stepY,
+                                 double originY = 0) {
+  double row = std::round(height / 2 - (y - originY) / stepY);
+  return (int)std::max(0.0, std::min((double)height, row));
+}
+
+/**
+ * @brief Ways of drawing curves into the cells of the grid. ASCII stamps one
+ * letter per cell, the others pack a grid of dots into each cell: 1x2 with
+ * half blocks, 2x4 with Braille patterns.
+ */
+enum class PlotMode { ASCII, HALFBLOCK, BRAILLE };
+
+/**
+ * @brief Gets the number of dots across a cell.
+ *
+ * @param mode PlotMode the plot mode.
+ * @return int the dots per column.
+ */
+static inline int plotDotsX(PlotMode mode) {
+  return mode == PlotMode::BRAILLE ? 2 : 1;
+}
+
+/**
+ * @brief Gets the number of dots down a cell.
+ *
+ * @param mode PlotMode the plot mode.
+ * @return int the dots per row.
+ */
+static inline int plotDotsY(PlotMode mode) {
+  return mode == PlotMode::BRAILLE ? 4 : mode == PlotMode::HALFBLOCK ? 2 : 1;
+}
+
+/**
+ * @brief Gets the x value of a column of dots, the dots of a cell spread
+ * evenly around the x value at its centre (so with one dot per cell this is
+ * plotX).
+ *
+ * @param column int the column of dots.
+ * @param width int the width of the grid in cells.
+ * @param dotsX int the dots across a cell.
+ * @param stepX double the x distance between cells.
+ * @param originX double the x value at the middle column.
+ * @return double the x value.
+ */
+static inline double plotDotX(int column,
+                              int width,
+                              int dotsX,
+                              double stepX,
+                              double originX = 0) {
+  return plotX(column / dotsX, width, stepX, originX) +
+         (column % dotsX - (dotsX - 1) / 2.0) * stepX / dotsX;
+}
+
+/**
+ * @brief Gets the row of dots a y value is plotted on, the dots of a cell
+ * spread evenly around the y value at its centre (so with one dot per cell
+ * this is plotRow).
+ *
+ * @param y double the y value.
+ * @param height int the height of the grid in cells.
+ * @param dotsY int the dots down a cell.
+ * @param stepY double the y distance between cells.
+ * @param originY double the y value at the middle row.
+ * @return int the row of dots, or -1 if it is off the grid (or undefined).
+ */
+static inline int plotDotRow(double y,
+                             int height,
+                             int dotsY,
+                             double stepY,
+                             double originY = 0) {
+  double row = std::round((height / 2) * dotsY + (dotsY - 1) / 2.0 -
+                          (y - originY) * dotsY / stepY);
+  if (!(row >= dotsY && row < height * dotsY))
+    return -1;
+  return (int)row;
+}
+
+/**
+ * @brief Gets the y value of a row of dots, the inverse of plotDotRow (so with
+ * one dot per cell, the y value at the centre of a row).
+ *
+ * @param row int the row of dots.
+ * @param height int the height of the grid in cells.
+ * @param dotsY int the dots down a cell.
+ * @param stepY double the y distance between cells.
+ * @param originY double the y value at the middle row.
+ * @return double the y value.
+ */
+static inline double plotDotY(int row,
+                              int height,
+                              int dotsY,
+                              double stepY,
+                              double originY = 0) {
+  return originY +
+         ((height / 2) * dotsY + (dotsY - 1) / 2.0 - row) * stepY / dotsY;
+}
+
+/**
+ * @brief Gets the row of dots a y value is plotted on, clamped to just past
+ * the edges of the grid so a vertical span reaching off the grid is still
+ * drawn up to its edge.
+ *
+ * @param y double the y value, must not be NaN.
+ * @param height int the height of the grid in cells.
+ * @param dotsY int the dots down a cell.
+ * @param stepY double the y distance between cells.
+ * @param originY double the y value at the middle row.
+ * @return int the row of dots, between dotsY - 1 and height * dotsY.
+ */
+static inline int plotDotRowClamped(double y,
+                                    int height,
+                                    int dotsY,
+                                    double stepY,
+                                    double originY = 0) {
+  double row = std::round((height / 2) * dotsY + (dotsY - 1) / 2.0 -
+                          (y - originY) * dotsY / stepY);
+  return (int)std::max(dotsY - 1.0, std::min((double)height * dotsY, row));
+}
+
+/**
+ * @brief Gets the bit of a dot within a cell, in the order of the Braille
+ * patterns block (dots 1-3 and 7 down the left, 4-6 and 8 down the right).
+ *
+ * @param dx int the column of the dot in the cell.
+ * @param dy int the row of the dot in the cell.
+ * @return uint8_t the bit.
+ */
+static inline uint8_t plotDotBit(int dx, int dy) {
+  return dy == 3 ? 0x40 << dx : 1 << (dx * 3 + dy);
+}
+
+/**
+ * @brief Gets the glyph showing the dots set in a cell.
+ *
+ * @param mode PlotMode the plot mode.
+ * @param bits uint8_t the dots set, see plotDotBit.
+ * @return char32_t the glyph, a space if no dots are set.
+ */
+static inline char32_t plotDotGlyph(PlotMode mode, uint8_t bits) {
+  if (bits == 0)
+    return U' ';
+  if (mode == PlotMode::BRAILLE)
+    return 0x2800 + bits;
+  // upper half, lower half, full block
+  static const char32_t blocks[] = {U' ', 0x2580, 0x2584, 0x2588};
+  return blocks[bits & 3];
+}
+
+/**
+ * @brief Gets the axis glyph drawn in an empty cell.
+ *
+ * @param i int the column of the cell.
+ * @param j int the row of the cell.
+ * @param width int the width of the grid.
+ * @param height int the height of the grid.
+ * @param panX int columns the view is panned right of the origin.
+ * @param panY int rows the view is panned above the origin.
+ * @return char the axis glyph, or a space if no axis passes the cell.
+ */
+static inline char axisGlyph(int i,
+                             int j,
+                             int width,
+                             int height,
+                             int panX = 0,
+                             int panY = 0) {
+  int x = i - width / 2 + panX;
+  int y = height / 2 - j + panY;
+  if (x == 0 && y == 0)
+    return '+';
+  else if (x == -1 && y == -1)
+    return 'O';
+  else if (x == 0)
+    return '|';
+  else if (y == 0)
+    return '-';
+  return ' ';
+}
+
+#endif
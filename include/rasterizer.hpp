@@ -0,0 +1,69 @@
+/**
+ * @file rasterizer.h
+ * @author Devin Arena
+ * @brief Offscreen rasterizer rendering equations to large PGM/PPM images in
+ * parallel tiles, with antialiased lines between samples.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_RASTERIZER_H
+#define TGRAPH_RASTERIZER_H
+
+#include <string>
+#include <vector>
+
+#include "environment.hpp"
+
+// width and height of the tiles the image is split into
+#define RASTER_TILE 256
+
+union Operand;
+
+class Rasterizer {
+ private:
+  /**
+   * @brief The region of the image a worker renders, band holds the rows
+   * starting at y for the full width of the image.
+   */
+  struct Tile {
+    unsigned char* band;
+    int x, y, w, h;
+  };
+  const Environment* env;
+  const std::vector<std::vector<Operand>>& programs;
+  // palette index of each program, so an equation keeps its colour when the
+  // ones before it are not rendered
+  const std::vector<int>& colours;
+  // world coordinates of the image edges
+  double left, right, bottom, top;
+  int width, height, channels;
+  // pixel row of every curve (program result) at every pixel column
+  std::vector<std::vector<double>> curves;
+  // palette index of each curve
+  std::vector<int> owners;
+  void sample();
+  void renderTile(const Tile& tile);
+  void plot(const Tile& tile,
+            int x,
+            int y,
+            double alpha,
+            const unsigned char* color);
+  void line(const Tile& tile,
+            double x0,
+            double y0,
+            double x1,
+            double y1,
+            const unsigned char* color);
+
+ public:
+  Rasterizer(const Environment* env,
+             const std::vector<std::vector<Operand>>& programs,
+             const std::vector<int>& colours,
+             double left,
+             double right,
+             double bottom,
+             double top);
+  bool render(const std::string& filename, int width, int height, bool color);
+};
+
+#endif
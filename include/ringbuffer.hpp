@@ -0,0 +1,60 @@
+/**
+ * @file ringbuffer.h
+ * @author Devin Arena
+ * @brief Fixed capacity ring buffer keeping the most recent items pushed, used
+ * for streamed samples.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_RINGBUFFER_H
+#define TGRAPH_RINGBUFFER_H
+
+#include <cstddef>
+#include <vector>
+
+template <typename T>
+class RingBuffer {
+ private:
+  std::vector<T> items;
+  // slot the next item is written to
+  size_t head;
+  size_t count;
+
+ public:
+  /**
+   * @brief Allocates the whole buffer up front, pushing never allocates.
+   *
+   * @param capacity size_t the number of items kept, at least 1.
+   */
+  RingBuffer(size_t capacity)
+      : items(capacity == 0 ? 1 : capacity), head(0), count(0) {}
+
+  /**
+   * @brief Adds an item, overwriting the oldest one when the buffer is full.
+   *
+   * @param item const T& the item to add.
+   */
+  void push(const T& item) {
+    items[head] = item;
+    head = head + 1 == items.size() ? 0 : head + 1;
+    if (count < items.size())
+      count++;
+  }
+
+  /**
+   * @brief Gets an item counting back from the most recent one.
+   *
+   * @param age size_t 0 for the most recent item, size() - 1 for the oldest.
+   * @return const T& the item.
+   */
+  const T& recent(size_t age) const {
+    size_t slot = head + items.size() - 1 - age;
+    return items[slot >= items.size() ? slot - items.size() : slot];
+  }
+
+  size_t size() const { return count; }
+  size_t capacity() const { return items.size(); }
+  bool empty() const { return count == 0; }
+};
+
+#endif
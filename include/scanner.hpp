@@ -10,13 +10,14 @@
 #define TGRAPH_SCANNER_H
 
 #include "builtins.hpp"
+#include "environment.hpp"
 
 #include <string>
 #include <vector>
 
 #define TOKEN(t) ((Token){.type = t})
 #define VALUE_TOKEN(v) ((Token){.value = v})
-#define FNPTR_TOKEN(ptr) ((Token){.fnptr = ptr})
+#define INDEX_TOKEN(i) ((Token){.index = i})
 
 enum class OP;
 
@@ -24,6 +25,7 @@ enum class OP;
 enum class TType {
   NONE, // None
   VAR, // e.g. x
+  VAR_Y, // y
   CONST, // e.g. 1.0, 5, -3.5
   ADD, // +
   SUB, // -
@@ -32,9 +34,21 @@ enum class TType {
   POW, // ^
   P_O_M,
   MAGIC, // ~
+  LESS, // <
+  LESS_EQUAL, // <=
+  GREATER, // >
+  GREATER_EQUAL, // >=
+  EQUAL, // ==
+  NOT_EQUAL, // !=
+  QUESTION, // ?
+  COLON, // :
+  COMMA, // ,
   O_PAREN, // (
   C_PAREN, // )
-  FUNC, // e.g. sin, cos, tan, etc.
+  FUNC, // e.g. sin, cos, min, clamp, followed by the opcode of the builtin
+  PARAM, // e.g. a after let a = 3
+  CALL, // e.g. g after let g(t) = t^2
+  ARG, // e.g. t inside the body of g(t)
   END
 };
 
@@ -42,14 +56,21 @@ enum class TType {
 union Token {
   TType type;
   double value;
-  BuiltinFunc fnptr;
+  int index;
 };
 
 class Scanner {
  private:
+  const Environment* env;
+  std::vector<std::string> names;
+  bool error;
+
  public:
-  Scanner();
-  std::vector<Token> scan(std::string& equation);
+  Scanner(const Environment* env = nullptr);
+  std::vector<Token> scan(const std::string& equation,
+                          const std::string& arg = "");
+  const std::vector<std::string>& getNames() const;
+  bool hadError() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+/**
+ * @file server.h
+ * @author Devin Arena
+ * @brief Local render server, answers render and evaluate requests over a
+ * unix socket from a worker pool sharing one compiled program cache.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_SERVER_H
+#define TGRAPH_SERVER_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "libtgraph.h"
+
+// compiled programs kept before the cache is emptied
+#define CACHE_LIMIT 4096
+
+/**
+ * @brief Thread-safe cache of compiled expressions keyed by their source.
+ * Lookups take a shared lock, so workers only contend when compiling an
+ * expression seen for the first time.
+ */
+class ProgramCache {
+ private:
+  std::unordered_map<std::string, std::shared_ptr<tg_program>> programs;
+  mutable std::shared_mutex mutex;
+
+ public:
+  std::shared_ptr<tg_program> get(const std::string& text);
+  size_t size() const;
+};
+
+/**
+ * @brief Accepts connections on a unix socket and serves them from a pool of
+ * worker threads, one connection per worker at a time.
+ */
+class Server {
+ private:
+  std::string path;
+  ProgramCache cache;
+  // accepted connections waiting for a worker
+  std::queue<int> connections;
+  std::mutex mutex;
+  std::condition_variable ready;
+  void worker();
+  void serve(int fd);
+  bool handle(const std::string& request, std::string& response);
+  bool render(std::istringstream& args, std::string& payload);
+  bool evaluate(std::istringstream& args, std::string& payload);
+
+ public:
+  Server(const std::string& path);
+  int run();
+};
+
+#endif
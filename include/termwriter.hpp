@@ -0,0 +1,98 @@
+/**
+ * @file termwriter.h
+ * @author Devin Arena
+ * @brief Writes frames to the terminal, only sending the cells that changed
+ * since the previous frame. Frames hold one code point per cell and are sent
+ * as UTF-8, optionally coloured with escapes sent only where the colour
+ * changes.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_TERMWRITER_H
+#define TGRAPH_TERMWRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Appends a code point to a string as UTF-8.
+ *
+ * @param out std::string& the string to append to.
+ * @param c char32_t the code point.
+ */
+static inline void appendUTF8(std::string& out, char32_t c) {
+  if (c < 0x80) {
+    out += (char)c;
+  } else if (c < 0x800) {
+    out += (char)(0xC0 | (c >> 6));
+    out += (char)(0x80 | (c & 0x3F));
+  } else if (c < 0x10000) {
+    out += (char)(0xE0 | (c >> 12));
+    out += (char)(0x80 | ((c >> 6) & 0x3F));
+    out += (char)(0x80 | (c & 0x3F));
+  } else {
+    out += (char)(0xF0 | (c >> 18));
+    out += (char)(0x80 | ((c >> 12) & 0x3F));
+    out += (char)(0x80 | ((c >> 6) & 0x3F));
+    out += (char)(0x80 | (c & 0x3F));
+  }
+}
+
+// how colours are sent: not at all, as one of the 16 ANSI colours, as one of
+// the 256 xterm colours or as 24 bit RGB
+enum class ColourMode { OFF, ANSI16, ANSI256, TRUECOLOR };
+
+// colours in the palette, a cell colour of 0 is the default colour and k is
+// entry k - 1
+#define PALETTE_SIZE 12
+
+// colours of the palette as a 16 colour SGR code, a 256 colour index and RGB
+struct PaletteEntry {
+  int ansi;
+  int xterm;
+  int r, g, b;
+};
+
+// shared with rendered images, so curves keep their colours there
+extern const PaletteEntry PALETTE[PALETTE_SIZE];
+
+// a row of cell colours, parallel to a row of a frame
+typedef std::vector<uint8_t> ColourRow;
+
+class TermWriter {
+ private:
+  // the frame currently shown on the terminal, and its colours
+  std::vector<std::u32string> front;
+  std::vector<ColourRow> frontColours;
+  // output for the current frame, written with a single call
+  std::string buffer;
+  // escape sequence selecting each cell colour, empty when colour is off
+  std::vector<std::string> escapes;
+  // colour selected on the terminal while encoding
+  uint8_t current;
+  void moveTo(int row, int col);
+  void appendCells(std::string& out,
+                   const std::u32string& row,
+                   const ColourRow* colours,
+                   size_t first,
+                   size_t last);
+  void resetColour(std::string& out);
+
+ public:
+  TermWriter();
+  void setColours(ColourMode mode);
+  bool coloured() const;
+  void present(const std::vector<std::u32string>& frame,
+               std::ostream& stream,
+               const std::vector<ColourRow>* colours = nullptr);
+  void encode(const std::vector<std::u32string>& frame,
+              const std::vector<ColourRow>* colours,
+              std::string& out);
+  void finish(std::ostream& stream);
+  void invalidate();
+  size_t footprint() const;
+};
+
+#endif
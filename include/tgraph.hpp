@@ -10,11 +10,32 @@
 #ifndef TGRAPH_TGRAPH_H
 #define TGRAPH_TGRAPH_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
 #include <vector>
 #include <stack>
 
 #include "./builtins.hpp"
+#include "alloctracker.hpp"
+#include "boundedqueue.hpp"
+#include "curve.hpp"
+#include "dataset.hpp"
+#include "environment.hpp"
+#include "field.hpp"
+#include "filewatcher.hpp"
+#include "opcodes.hpp"
+#include "optimizer.hpp"
+#include "pane.hpp"
 #include "parser.hpp"
+#include "plot.hpp"
+#include "ringbuffer.hpp"
+#include "termwriter.hpp"
+#include "vm.hpp"
 
 // version infos
 
@@ -31,56 +52,217 @@
 #define TG_LINUX
 #endif
 
-// compiling with debug on prints out opcodes as the program runs
+// column stride of the first pass of a progressive render, and how long the
+// remaining passes must be expected to take for a pass to be drawn
+#define REFINE_STRIDE 8
+#define REFINE_FRAME_MS 20
 
-// #define TG_DEBUG
+// minimum time and maximum number of runs over the view when profiling
+#define PROFILE_MS 50
+#define PROFILE_MAX_RUNS 100000
 
-// Helper macros for creating Operand unions.
-#define OPCODE(op) ((Operand){.opcode = op})
-#define VALUE(val) ((Operand){.value = val})
-#define FUNC(ptr) ((Operand){.fnptr = ptr})
+// samples kept while streaming, bytes read from stdin at once, frame rate
+#define STREAM_CAPACITY (1 << 16)
+#define STREAM_CHUNK (1 << 16)
+#define STREAM_FPS 30
 
-// Opcodes for the instruction set, opcodes are generated by the Pratt parser
-// and interpreted by TGraph.
-enum class OP { VAR, CONST, NEG, ADD, SUB, MUL, DIV, POW, PLUS_OR_MINUS, MAGIC, BUILTIN, END };
+// a streamed sample, t is the sample number when only y values are given
+struct StreamSample {
+  double t;
+  double y;
+};
 
-// overload operator for +(enum class) to give its ordinum
-template <typename T>
-constexpr auto operator+(T e) noexcept
-    -> std::enable_if_t<std::is_enum<T>::value, std::underlying_type_t<T>> {
-  return static_cast<std::underlying_type_t<T>>(e);
-}
+// a line of a watched file and what it added, an equation (by index), field,
+// curve or dataset, none for other commands
+struct WatchedLine {
+  std::string text;
+  int equation{-1};
+  const Field* field{nullptr};
+  const Curve* curve{nullptr};
+  const Dataset* dataset{nullptr};
+};
 
-// Operand union for the instruction set.
-union Operand {
-  OP opcode;
-  double value;
-  BuiltinFunc fnptr;
+// allocations made by each phase of the last drawn frame, and how many frames
+// were drawn and went over ALLOC_FRAME_BUDGET (zero unless TG_ALLOC_TRACK)
+struct FrameAllocations {
+  AllocCount compute;
+  AllocCount plot;
+  AllocCount draw;
+  uint64_t frames{0};
+  uint64_t overBudget{0};
 };
 
 class TGraph {
  private:
-  // screen width and height of the terminal
+  // size of the terminal (until it is read, or set by a replayed session),
+  // and the width and height of the view (the whole terminal unless split)
+  int terminalWidth{80};
+  int terminalHeight{24};
   int screenWidth;
   int screenHeight;
   double stepX{1.0};
   double stepY{1.0};
+  // the point at the centre of the view
+  double originX{0.0};
+  double originY{0.0};
+  // how curves are drawn, and the dots they set in each cell (row major)
+  // when drawn with more than one dot per cell
+  PlotMode mode{PlotMode::ASCII};
+  std::vector<uint8_t> dots;
   std::vector<std::vector<char>> screen;
+  // heat map shading of each cell (row major), drawn below curves and dots, 0
+  // where text is written
+  std::vector<char> shades;
+  // colour of each cell of the screen (row major), 0 for the default colour
+  std::vector<uint8_t> colours;
   std::vector<std::vector<Operand>> ops;
   std::vector<std::string> equations;
+  // user-definable names each equation depends on
+  std::vector<std::vector<std::string>> deps;
+  // cached y values of each equation, one row of results per column of dots
+  std::vector<std::vector<double>> samples;
+  std::vector<size_t> strides;
+  // whether the view shows each equation, equations past the end are shown
+  std::vector<char> shown;
+  // viewports the terminal is split into, the pane commands apply to, and
+  // the pane whose view is loaded into the members above (the active pane
+  // except while the panes are drawn)
+  std::vector<Pane> panes;
+  int active{0};
+  int focused{0};
+  // a VM per worker computing panes
+  std::vector<VM> paneVMs;
+  // x-only subexpressions hoisted out of an animation, one value per column
+  std::vector<std::vector<double>> cache;
+  // loaded datasets and the min and max y of their points in each column
+  std::vector<std::unique_ptr<Dataset>> datasets;
+  std::vector<std::vector<double>> dataLows;
+  std::vector<std::vector<double>> dataHighs;
+  // implicit plots and heat maps of expressions of x and y
+  std::vector<std::unique_ptr<Field>> fields;
+  // parametric and polar curves
+  std::vector<std::unique_ptr<Curve>> curves;
+  // the file of equations and commands being watched, and its lines
+  FileWatcher watcher;
+  std::vector<WatchedLine> watched;
+  // final glyphs of the last composed frame, and the frame as UTF-8
+  std::vector<std::u32string> frame;
+  std::vector<ColourRow> frameColours;
+  std::string output;
+  // reused by every render, so redrawing a steady view does not allocate
+  std::vector<int> everyEquation;
+  std::vector<double> passResults;
+  // allocations of the last frame, and of computing since it was drawn
+  FrameAllocations frameAllocs;
+  AllocCount computing;
+  // lines typed at the prompt, waiting for the render thread
+  BoundedQueue<std::string, 64> commands;
+  std::atomic<int> pending{0};
+  std::mutex wakeMutex;
+  std::condition_variable wake;
+  // true while the render thread runs, renders then give up when superseded
+  bool async{false};
+  // replaying a session, the terminal size is set by the session and
+  // nothing is shown
+  bool headless{false};
+  // commands of the session are written to recording when it is open
+  std::ofstream recording;
+  std::chrono::steady_clock::time_point recordStart;
+  // an abandoned render left the cached samples stale
+  bool dirty{false};
+  Environment env;
   Parser parser;
   Scanner scanner;
-  void writeToScreen(std::string text, int x, int y);
+  Optimizer optimizer;
+  VM vm;
+  TermWriter writer;
+  void readWindowSize();
+  void resize(int width, int height);
+  void writeToScreen(std::string_view text, int x, int y, uint8_t colour = 0);
+  void resetScreen();
+  char32_t cellAt(int i, int j) const;
+  int sampleColumns() const;
+  double sampleX(int column) const;
+  void setMode(const std::string& name);
+  void setColours(const std::string& name);
+  void compose();
+  void plot();
+  void layout();
+  void swapView(View& view);
+  void focus(int pane);
+  void split(bool horizontal);
+  void selectPane(const std::vector<std::string>& tokens);
+  bool computeEquations(const std::vector<int>& targets);
+  bool computePanes(const std::vector<int>& targets);
+  bool computePane(int pane,
+                   const std::vector<int>& targets,
+                   const std::vector<int>& sources,
+                   VM& machine);
+  bool plotPanes();
+  bool computePoints(int equation, std::vector<Operand>& program);
+  bool computeColumns(int equation,
+                      std::vector<Operand>& program,
+                      int first,
+                      int last);
+  bool refine(const std::vector<int>& targets);
+  bool computePass(int equation, int pass);
+  bool cancelled() const;
+  void settle();
+  void renderLoop();
+  bool compile(int equation);
+  void computeData(int dataset);
+  void computeDataColumns(int dataset, int first, int last);
+  void pan(int columns, int rows);
+  void plotData(int dataset);
+  void addField(FieldKind kind, const std::string& expression);
+  bool compileField(int field);
+  bool computeField(int field);
+  bool computeFields();
+  void plotField(int field);
+  void addCurve(CurveKind kind, const std::string& definition);
+  bool compileCurve(int curve);
+  bool compileBody(const std::string& body,
+                   const std::string& arg,
+                   std::vector<Operand>& program,
+                   std::vector<std::string>& names);
+  bool evaluateConstant(const std::string& text, double& value);
+  void computeCurve(int curve);
+  void computeCurves();
+  void plotCurve(int curve);
+  void load(const std::string& filename);
+  bool resolveProgram(const std::string& target,
+                      std::vector<Operand>& program);
+  void profile(const std::string& target);
+  void memory();
+  bool evaluateParam(const std::string& body,
+                     double& value,
+                     std::vector<std::string>& names);
+  void define(const std::string& definition);
+  void updateDependents(const std::string& name, bool recompile);
+  void watch(const std::string& filename);
+  void reloadWatched();
+  void removeEquation(int equation);
+  void moveLastEquation(int at);
 
  public:
-  TGraph();
+  explicit TGraph(bool headless = false);
   void setupWindow();
-  void computePoints(int equation);
+  bool computePoints(int equation);
+  void plotPoints(int equation);
   void cli();
-  void draw(std::ostream& stream);
+  void draw(std::ostream& stream, bool colour = false);
   void rerender();
-  void parseEquation(std::string& equation);
-  std::vector<double> simulateEquation(double x, int equation);
+  void redraw();
+  void animate(const std::string& name,
+               double from,
+               double to,
+               double fps,
+               double seconds);
+  void stream();
+  bool record(const std::string& filename);
+  int replay(const std::string& filename, double speed);
+  bool parseEquation(std::string& equation);
+  size_t simulateEquation(double x, int equation, double* out);
   void parseInput(std::string input);
   int getGraphed() const;
 };
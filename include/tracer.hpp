@@ -0,0 +1,102 @@
+/**
+ * @file tracer.h
+ * @author Devin Arena
+ * @brief Records a timeline of what each thread is doing as Chrome trace
+ * events (viewable in chrome://tracing or Perfetto), enabled by --trace.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_TRACER_H
+#define TGRAPH_TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "alloctracker.hpp"
+
+// traces the rest of the enclosing scope as an event, with an optional value
+// shown in its arguments (e.g. the index of an equation)
+#define TG_TRACE_CAT(a, b) a##b
+#define TG_TRACE_NAME(line) TG_TRACE_CAT(traceScope, line)
+#define TG_TRACE(name, ...) \
+  TraceScope TG_TRACE_NAME(__LINE__)(name, ##__VA_ARGS__)
+
+class Tracer {
+ private:
+  struct Event {
+    std::string name;
+    char phase;
+    int tid;
+    uint64_t start;
+    uint64_t duration;
+    uint64_t frame;
+    long value;
+    AllocCount allocated;
+  };
+  std::atomic<bool> active;
+  std::atomic<uint64_t> frame;
+  std::atomic<int> threads;
+  std::chrono::steady_clock::time_point origin;
+  std::string path;
+  std::mutex mutex;
+  std::vector<Event> events;
+  Tracer();
+  static void flushAtExit();
+
+ public:
+  static Tracer& instance();
+  bool open(const std::string& path);
+  bool flush();
+  /**
+   * @brief Checks if events are being recorded, cheap enough to call from
+   * any loop.
+   *
+   * @return bool true if tracing.
+   */
+  bool enabled() const { return active.load(std::memory_order_relaxed); }
+  uint64_t now() const;
+  int threadId();
+  void nameThread(const std::string& name);
+  void record(const std::string& name,
+              uint64_t start,
+              uint64_t duration,
+              long value,
+              const AllocCount& allocated);
+  void nextFrame();
+};
+
+/**
+ * @brief Records the lifetime of a scope as a complete event on the calling
+ * thread, with the allocations the thread made during it. Does nothing
+ * unless tracing.
+ */
+class TraceScope {
+ private:
+  const char* name;
+  long value;
+  uint64_t start;
+  AllocCount allocated;
+
+ public:
+  TraceScope(const char* name, long value = -1) : name(name), value(value) {
+    Tracer& tracer = Tracer::instance();
+    start = tracer.enabled() ? tracer.now() : 0;
+    if (tracer.enabled())
+      allocated = threadAllocations();
+  }
+  ~TraceScope() {
+    Tracer& tracer = Tracer::instance();
+    if (!tracer.enabled())
+      return;
+    AllocCount now = threadAllocations();
+    now.allocations -= allocated.allocations;
+    now.bytes -= allocated.bytes;
+    tracer.record(name, start, tracer.now() - start, value, now);
+  }
+};
+
+#endif
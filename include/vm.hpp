@@ -0,0 +1,71 @@
+/**
+ * @file vm.h
+ * @author Devin Arena
+ * @brief Stack virtual machine interpreting the opcodes generated by the
+ * parser, one x at a time or in batches.
+ * @since 10/19/2026
+ **/
+
+#ifndef TGRAPH_VM_H
+#define TGRAPH_VM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "environment.hpp"
+
+// number of x values evaluated together by runBatch
+#define VM_BATCH 256
+
+// profiles are timed in cycles with rdtsc where available, else nanoseconds
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define TG_RDTSC
+#endif
+
+union Operand;
+
+/**
+ * @brief Execution statistics of a program collected by runBatch, indexed like
+ * the program (the operand slot after CONST, PARAM or CACHED and the
+ * coefficients of POLY stay empty). Counts are per x value, cycles are for the whole batch.
+ */
+struct VMProfile {
+  std::vector<uint64_t> counts;
+  std::vector<uint64_t> cycles;
+  size_t maxDepth{0};
+};
+
+class VM {
+ private:
+  const Environment* env;
+  // values hoisted out of an animation, one array per CACHED slot
+  const std::vector<std::vector<double>>* cache;
+  // batch stack, each entry is VM_BATCH lanes wide
+  std::vector<double> lanes;
+  // statistics collected by runBatch, if profiling
+  VMProfile* profile;
+  double* lane(size_t depth);
+
+ public:
+  VM(const Environment* env = nullptr,
+     const std::vector<std::vector<double>>* cache = nullptr);
+  std::vector<double> run(std::vector<Operand>& program,
+                          double x,
+                          int column = 0,
+                          double y = 0);
+  size_t runBatch(const std::vector<Operand>& program,
+                  const double* xs,
+                  size_t n,
+                  double* out,
+                  int column = 0,
+                  const double* ys = nullptr);
+  void setProfile(VMProfile* profile);
+  size_t footprint() const;
+  static size_t results(const std::vector<Operand>& program);
+  static bool usesX(const std::vector<Operand>& program);
+  static bool usesY(const std::vector<Operand>& program);
+  static uint64_t readCycles();
+};
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file alloctracker.cpp
+ * @author Devin Arena
+ * @brief Implementation file for allocation tracking, including the
+ * replacement global operator new and delete when TG_ALLOC_TRACK is defined.
+ * @since 10/19/2026
+ **/
+
+#include "../include/alloctracker.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef TG_ALLOC_TRACK
+
+// every thread counts its own allocations without contention, the totals
+// across threads are kept separately
+static thread_local uint64_t threadCount = 0;
+static thread_local uint64_t threadBytes = 0;
+static std::atomic<uint64_t> totalCount{0};
+static std::atomic<uint64_t> totalBytes{0};
+static std::atomic<uint64_t> freedCount{0};
+
+/**
+ * @brief Counts an allocation of size bytes.
+ *
+ * @param size std::size_t the size of the allocation.
+ */
+static void countAllocation(std::size_t size) {
+  threadCount++;
+  threadBytes += size;
+  totalCount.fetch_add(1, std::memory_order_relaxed);
+  totalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+  countAllocation(size);
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  countAllocation(size);
+  std::size_t align = (std::size_t)alignment;
+  // aligned_alloc needs a multiple of the alignment
+  void* p = std::aligned_alloc(align, (size + align - 1) / align * align);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return operator new(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+  if (p == nullptr)
+    return;
+  freedCount.fetch_add(1, std::memory_order_relaxed);
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+  operator delete(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+  operator delete(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+  operator delete(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+  operator delete(p);
+}
+
+#endif
+
+/**
+ * @brief Checks if allocations are being counted.
+ *
+ * @return bool true if compiled with TG_ALLOC_TRACK.
+ */
+bool allocTracking() {
+#ifdef TG_ALLOC_TRACK
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Gets the allocations made by the calling thread so far.
+ *
+ * @return AllocCount the number of allocations and bytes allocated.
+ */
+AllocCount threadAllocations() {
+  AllocCount count;
+#ifdef TG_ALLOC_TRACK
+  count.allocations = threadCount;
+  count.bytes = threadBytes;
+#endif
+  return count;
+}
+
+/**
+ * @brief Gets the allocations made by every thread so far.
+ *
+ * @return AllocCount the number of allocations and bytes allocated.
+ */
+AllocCount totalAllocations() {
+  AllocCount count;
+#ifdef TG_ALLOC_TRACK
+  count.allocations = totalCount.load(std::memory_order_relaxed);
+  count.bytes = totalBytes.load(std::memory_order_relaxed);
+#endif
+  return count;
+}
+
+/**
+ * @brief Gets the number of allocations that have not been freed yet.
+ *
+ * @return uint64_t the number of live allocations.
+ */
+uint64_t liveAllocations() {
+#ifdef TG_ALLOC_TRACK
+  return totalCount.load(std::memory_order_relaxed) -
+         freedCount.load(std::memory_order_relaxed);
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,210 @@
+/**
+ * @file curve.cpp
+ * @author Devin Arena
+ * @brief Implementation file for parametric and polar curves.
+ * @since 10/19/2026
+ **/
+
+#include "../include/curve.hpp"
+#include "../include/opcodes.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+/**
+ * @brief Checks if a value computed by the VM is defined.
+ *
+ * @param v double the value.
+ * @return bool false for NaN, infinities and the domain error sentinels.
+ */
+static inline bool defined(double v) {
+  return std::isfinite(v) && v != INT_MIN && v != INT_MAX;
+}
+
+/**
+ * @brief Default constructor, the curve has no program until setProgram.
+ *
+ * @param kind CurveKind whether the program computes x and y, or r.
+ * @param expression const std::string& the source, shown as the label.
+ * @param env const Environment* parameter values, may be null.
+ */
+Curve::Curve(CurveKind kind,
+             const std::string& expression,
+             const Environment* env)
+    : kind(kind), expression(expression), t0(0), t1(0), vm(env) {}
+
+/**
+ * @brief Sets the compiled curve and the range of its parameter.
+ *
+ * @param program const std::vector<Operand>& computes x then y of the
+ * parameter (parametric), or r of the angle (polar).
+ * @param deps const std::vector<std::string>& the user-definable names it
+ * depends on.
+ * @param t0 double the first parameter value.
+ * @param t1 double the last parameter value.
+ */
+void Curve::setProgram(const std::vector<Operand>& program,
+                       const std::vector<std::string>& deps,
+                       double t0,
+                       double t1) {
+  this->program = program;
+  this->deps = deps;
+  this->t0 = t0;
+  this->t1 = t1;
+}
+
+/**
+ * @brief Evaluates x and y at every sampled parameter value in one batched
+ * pass and converts them to dot positions.
+ *
+ * @param left double the x value of the first column of dots.
+ * @param top double the y value of the first row of dots.
+ * @param scaleX double columns of dots per unit of x.
+ * @param scaleY double rows of dots per unit of y.
+ */
+void Curve::evaluate(double left, double top, double scaleX, double scaleY) {
+  size_t stride = VM::results(program);
+  out.resize(VM_BATCH * stride);
+  points.resize(ts.size() * 2);
+  for (size_t i = 0; i < ts.size(); i += VM_BATCH) {
+    size_t n = std::min<size_t>(VM_BATCH, ts.size() - i);
+    vm.runBatch(program, &ts[i], n, out.data());
+    for (size_t k = 0; k < n; k++) {
+      double x, y;
+      bool valid;
+      if (kind == CurveKind::POLAR) {
+        double r = out[k];
+        valid = defined(r);
+        x = r * std::cos(ts[i + k]);
+        y = r * std::sin(ts[i + k]);
+      } else {
+        x = out[k * 2];
+        y = out[k * 2 + 1];
+        valid = defined(x) && defined(y);
+      }
+      points[(i + k) * 2] = valid ? (x - left) * scaleX : NAN;
+      points[(i + k) * 2 + 1] = valid ? (top - y) * scaleY : NAN;
+    }
+  }
+}
+
+/**
+ * @brief Gets the number of samples a segment of the first pass is split
+ * into, from its length on the screen. Segments off one side of the screen
+ * are not split.
+ *
+ * @param segment size_t the index of the segment (and its first point).
+ * @param columns int the columns of dots on the screen.
+ * @param rows int the rows of dots on the screen.
+ * @return int the number of samples, at least 1.
+ */
+int Curve::splits(size_t segment, int columns, int rows) const {
+  double c0 = points[segment * 2];
+  double r0 = points[segment * 2 + 1];
+  double c1 = points[segment * 2 + 2];
+  double r1 = points[segment * 2 + 3];
+  // look closer at where the curve becomes undefined
+  if (std::isnan(c0) || std::isnan(c1))
+    return CURVE_UNDEFINED_SPLIT;
+  if ((c0 < 0 && c1 < 0) || (c0 >= columns && c1 >= columns) ||
+      (r0 < 0 && r1 < 0) || (r0 >= rows && r1 >= rows))
+    return 1;
+  double length = std::hypot(c1 - c0, r1 - r0);
+  return (int)std::min<double>(CURVE_MAX_SPLIT,
+                               std::max(1.0, length / CURVE_SPACING));
+}
+
+/**
+ * @brief Samples the curve for the screen. A uniform first pass over the
+ * parameter range measures how far each segment travels on the screen, then
+ * each is split into samples CURVE_SPACING dots apart and the curve is
+ * evaluated again at those, so tight loops get more samples and short or
+ * off-screen runs fewer.
+ *
+ * @param left double the x value of the first column of dots.
+ * @param top double the y value of the first row of dots.
+ * @param scaleX double columns of dots per unit of x.
+ * @param scaleY double rows of dots per unit of y.
+ * @param columns int the columns of dots on the screen.
+ * @param rows int the rows of dots on the screen.
+ */
+void Curve::sample(double left,
+                   double top,
+                   double scaleX,
+                   double scaleY,
+                   int columns,
+                   int rows) {
+  ts.resize(CURVE_COARSE + 1);
+  for (int i = 0; i <= CURVE_COARSE; i++) {
+    ts[i] = t0 + (t1 - t0) * i / CURVE_COARSE;
+  }
+  evaluate(left, top, scaleX, scaleY);
+
+  std::vector<int> counts(CURVE_COARSE);
+  size_t total = 1;
+  for (int s = 0; s < CURVE_COARSE; s++) {
+    counts[s] = splits(s, columns, rows);
+    total += counts[s];
+  }
+  std::vector<double> coarse(ts);
+  ts.resize(total);
+  size_t k = 0;
+  for (int s = 0; s < CURVE_COARSE; s++) {
+    for (int j = 0; j < counts[s]; j++)
+      ts[k++] = coarse[s] + (coarse[s + 1] - coarse[s]) * j / counts[s];
+  }
+  ts[k] = coarse.back();
+  evaluate(left, top, scaleX, scaleY);
+}
+
+// Getters and Setters
+
+/**
+ * @brief Gets whether the curve is parametric or polar.
+ *
+ * @return CurveKind the kind of curve.
+ */
+CurveKind Curve::getKind() const {
+  return kind;
+}
+
+/**
+ * @brief Gets the source of the curve.
+ *
+ * @return const std::string& the expression.
+ */
+const std::string& Curve::getExpression() const {
+  return expression;
+}
+
+/**
+ * @brief Gets the user-definable names the curve depends on.
+ *
+ * @return const std::vector<std::string>& the names.
+ */
+const std::vector<std::string>& Curve::getDeps() const {
+  return deps;
+}
+
+/**
+ * @brief Gets the sampled positions.
+ *
+ * @return const std::vector<double>& column and row of dots of each sample,
+ * NaN where the curve is undefined.
+ */
+const std::vector<double>& Curve::getPoints() const {
+  return points;
+}
+
+/**
+ * @brief Gets the memory held by the program and the samples.
+ *
+ * @return size_t the size in bytes.
+ */
+size_t Curve::footprint() const {
+  return program.capacity() * sizeof(Operand) +
+         (ts.capacity() + points.capacity() + out.capacity()) *
+             sizeof(double) +
+         vm.footprint();
+}
@@ -0,0 +1,376 @@
+/**
+ * @file dataset.cpp
+ * @author Devin Arena
+ * @brief Implementation file for dataset class.
+ * @since 10/19/2026
+ **/
+
+#include "../include/dataset.hpp"
+#include "../include/parallel.hpp"
+#include "../include/tgraph.hpp"
+
+#ifdef TG_LINUX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+// bytes of CSV text read at a time while converting
+#define READ_CHUNK (1 << 20)
+// lowest level blocks summarized by each parallel task
+#define BLOCKS_PER_TASK 1024
+
+/**
+ * @brief Default constructor.
+ */
+Dataset::Dataset()
+    : points(nullptr), count(0), mapping(nullptr), mappedBytes(0) {}
+
+/**
+ * @brief Unmaps the points.
+ */
+Dataset::~Dataset() {
+#ifdef TG_LINUX
+  if (mapping != nullptr)
+    munmap(mapping, mappedBytes);
+#endif
+}
+
+/**
+ * @brief Loads a dataset. Files ending in .f64 or .bin hold raw native float64
+ * x,y pairs (e.g. from export ... f64) and are mapped directly, anything else
+ * is read as CSV and converted to raw pairs in a temporary file first. The x
+ * values must be increasing.
+ *
+ * @param path const std::string& the file to load.
+ * @return bool true if the dataset was loaded.
+ */
+bool Dataset::load(const std::string& path) {
+  std::string extension =
+      path.size() > 4 ? path.substr(path.size() - 4) : std::string{""};
+  FILE* file;
+  if (extension.compare(".f64") == 0 || extension.compare(".bin") == 0)
+    file = fopen(path.c_str(), "rb");
+  else
+    file = convertCSV(path);
+  if (file == nullptr)
+    return false;
+  // the mapping keeps the file alive, even the deleted temporary file
+  bool mapped = map(file);
+  fclose(file);
+  if (!mapped || count == 0)
+    return false;
+  name = path;
+  return buildPyramid();
+}
+
+/**
+ * @brief Parses a CSV file into raw x,y pairs in a temporary file. Lines
+ * without at least two numbers (e.g. a header) are skipped, values after the
+ * first two are ignored.
+ *
+ * @param path const std::string& the CSV file.
+ * @return FILE* the temporary file, or nullptr on failure.
+ */
+FILE* Dataset::convertCSV(const std::string& path) {
+  FILE* in = fopen(path.c_str(), "rb");
+  if (in == nullptr)
+    return nullptr;
+  FILE* out = tmpfile();
+  if (out == nullptr) {
+    fclose(in);
+    return nullptr;
+  }
+  std::vector<char> buffer(READ_CHUNK + 1);
+  std::vector<double> pairs;
+  pairs.reserve(READ_CHUNK / 4);
+  size_t pending = 0;
+  bool open = true;
+  while (open) {
+    size_t got = fread(buffer.data() + pending, 1, READ_CHUNK - pending, in);
+    if (got == 0) {
+      open = false;
+      if (pending > 0)
+        buffer[pending++] = '\n';
+    }
+    pending += got;
+    char* line = buffer.data();
+    char* end = line + pending;
+    char* newline;
+    while ((newline = (char*)memchr(line, '\n', end - line)) != nullptr) {
+      *newline = '\0';
+      double values[2];
+      int n = 0;
+      char* next;
+      while (n < 2) {
+        while (*line == ' ' || *line == '\t' || *line == ',') {
+          line++;
+        }
+        values[n] = strtod(line, &next);
+        if (next == line)
+          break;
+        line = next;
+        n++;
+      }
+      if (n == 2) {
+        pairs.push_back(values[0]);
+        pairs.push_back(values[1]);
+      }
+      line = newline + 1;
+    }
+    pending = end - line;
+    if (pending == READ_CHUNK)
+      pending = 0;
+    memmove(buffer.data(), line, pending);
+    fwrite(pairs.data(), sizeof(double), pairs.size(), out);
+    pairs.clear();
+  }
+  bool ok = !ferror(in) && !ferror(out) && fflush(out) == 0;
+  fclose(in);
+  if (!ok) {
+    fclose(out);
+    return nullptr;
+  }
+  return out;
+}
+
+/**
+ * @brief Maps the x,y pairs of a raw float64 file, reading them into memory
+ * instead on platforms without mmap.
+ *
+ * @param file FILE* the file of pairs.
+ * @return bool true if the pairs were mapped.
+ */
+bool Dataset::map(FILE* file) {
+#ifdef TG_LINUX
+  struct stat info;
+  if (fstat(fileno(file), &info) != 0 || info.st_size % (2 * sizeof(double)))
+    return false;
+  count = info.st_size / (2 * sizeof(double));
+  if (count == 0)
+    return true;
+  mappedBytes = info.st_size;
+  mapping =
+      mmap(nullptr, mappedBytes, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+  if (mapping == MAP_FAILED) {
+    mapping = nullptr;
+    count = 0;
+    return false;
+  }
+  points = (const double*)mapping;
+#else
+  if (fseek(file, 0, SEEK_END) != 0)
+    return false;
+  long size = ftell(file);
+  if (size < 0 || size % (2 * sizeof(double)))
+    return false;
+  count = size / (2 * sizeof(double));
+  fallback.resize(count * 2);
+  rewind(file);
+  if (fread(fallback.data(), 2 * sizeof(double), count, file) != count)
+    return false;
+  points = fallback.data();
+#endif
+  return true;
+}
+
+/**
+ * @brief Builds the min/max pyramid in one pass over the points, checking
+ * that the x values are increasing along the way. The lowest level is built
+ * in parallel, the levels above it are small.
+ *
+ * @return bool false if the x values are not increasing.
+ */
+bool Dataset::buildPyramid() {
+#ifdef TG_LINUX
+  madvise(mapping, mappedBytes, MADV_SEQUENTIAL);
+#endif
+  size_t blocks = (count + DATA_BLOCK - 1) / DATA_BLOCK;
+  lows.assign(1, std::vector<double>(blocks));
+  highs.assign(1, std::vector<double>(blocks));
+  std::atomic<bool> sorted{true};
+  size_t tasks = (blocks + BLOCKS_PER_TASK - 1) / BLOCKS_PER_TASK;
+  parallelFor(tasks, [&](unsigned, size_t task) {
+    size_t firstBlock = task * BLOCKS_PER_TASK;
+    size_t lastBlock = std::min(blocks, firstBlock + BLOCKS_PER_TASK);
+    for (size_t block = firstBlock; block < lastBlock; block++) {
+      size_t first = block * DATA_BLOCK;
+      size_t last = std::min(count, first + DATA_BLOCK);
+      double low = std::numeric_limits<double>::infinity();
+      double high = -low;
+      // also compares across the boundary with the previous block
+      double prev = first > 0 ? points[2 * (first - 1)] : high;
+      bool ordered = true;
+      for (size_t i = first; i < last; i++) {
+        double x = points[2 * i];
+        double y = points[2 * i + 1];
+        ordered &= x >= prev;
+        prev = x;
+        // NaN y values fail both comparisons and are skipped
+        if (y < low)
+          low = y;
+        if (y > high)
+          high = y;
+      }
+      lows[0][block] = low;
+      highs[0][block] = high;
+      if (!ordered)
+        sorted = false;
+    }
+  });
+  for (size_t level = 0; lows[level].size() > 1; level++) {
+    size_t size = (lows[level].size() + 1) / 2;
+    std::vector<double> low(size);
+    std::vector<double> high(size);
+    for (size_t j = 0; j < size; j++) {
+      size_t right = std::min(2 * j + 1, lows[level].size() - 1);
+      low[j] = std::min(lows[level][2 * j], lows[level][right]);
+      high[j] = std::max(highs[level][2 * j], highs[level][right]);
+    }
+    lows.push_back(std::move(low));
+    highs.push_back(std::move(high));
+  }
+#ifdef TG_LINUX
+  madvise(mapping, mappedBytes, MADV_RANDOM);
+#endif
+  return sorted;
+}
+
+/**
+ * @brief Finds the first point whose x value is at least x.
+ *
+ * @param x double the x value to search for.
+ * @return size_t the index of the point, count if there is none.
+ */
+size_t Dataset::lowerBound(double x) const {
+  size_t first = 0;
+  size_t last = count;
+  while (first < last) {
+    size_t mid = first + (last - first) / 2;
+    if (points[2 * mid] < x)
+      first = mid + 1;
+    else
+      last = mid;
+  }
+  return first;
+}
+
+/**
+ * @brief Finds the min and max y of the points in [first, last). Whole blocks
+ * are covered by the fewest pyramid entries, from the lowest level up, and
+ * only the partial blocks at either end are scanned.
+ *
+ * @param first size_t the first point.
+ * @param last size_t one past the last point.
+ * @param low double& receives the min, greater than high if there are none.
+ * @param high double& receives the max.
+ */
+void Dataset::rangeMinMax(size_t first,
+                          size_t last,
+                          double& low,
+                          double& high) const {
+  low = std::numeric_limits<double>::infinity();
+  high = -low;
+  size_t left = (first + DATA_BLOCK - 1) / DATA_BLOCK;
+  size_t right = last / DATA_BLOCK;
+  if (left >= right) {
+    left = right = last;
+  } else {
+    for (size_t level = 0; left < right; level++) {
+      if (left & 1) {
+        low = std::min(low, lows[level][left]);
+        high = std::max(high, highs[level][left]);
+        left++;
+      }
+      if (right & 1) {
+        right--;
+        low = std::min(low, lows[level][right]);
+        high = std::max(high, highs[level][right]);
+      }
+      left >>= 1;
+      right >>= 1;
+    }
+    left = (first + DATA_BLOCK - 1) / DATA_BLOCK * DATA_BLOCK;
+    right = last / DATA_BLOCK * DATA_BLOCK;
+  }
+  // points before the first whole block and after the last one
+  for (size_t i = first; i < std::min(left, last); i++) {
+    double y = points[2 * i + 1];
+    if (y < low)
+      low = y;
+    if (y > high)
+      high = y;
+  }
+  for (size_t i = std::max(right, first); i < last; i++) {
+    double y = points[2 * i + 1];
+    if (y < low)
+      low = y;
+    if (y > high)
+      high = y;
+  }
+}
+
+/**
+ * @brief Finds the min and max y of the points in each column, column i
+ * covering x values in [left + i * step, left + (i + 1) * step).
+ *
+ * @param left double the x value at the left edge of the first column.
+ * @param step double the width of a column.
+ * @param width int the number of columns.
+ * @param low double* receives the min of each column, NaN if it has no points.
+ * @param high double* receives the max of each column, NaN if it has none.
+ */
+void Dataset::columns(double left,
+                      double step,
+                      int width,
+                      double* low,
+                      double* high) const {
+  size_t first = lowerBound(left);
+  for (int i = 0; i < width; i++) {
+    size_t last = lowerBound(left + (i + 1) * step);
+    rangeMinMax(first, last, low[i], high[i]);
+    if (low[i] > high[i])
+      low[i] = high[i] = NAN;
+    first = last;
+  }
+}
+
+// Getters and Setters
+
+/**
+ * @brief Gets the file the dataset was loaded from.
+ *
+ * @return const std::string& the file name.
+ */
+const std::string& Dataset::getName() const {
+  return name;
+}
+
+/**
+ * @brief Gets the number of points.
+ *
+ * @return size_t the number of points.
+ */
+size_t Dataset::size() const {
+  return count;
+}
+
+/**
+ * @brief Gets the memory held by the pyramid (and the points, on platforms
+ * without mmap). Mapped points are paged in by the kernel and not counted.
+ *
+ * @return size_t the size in bytes.
+ */
+size_t Dataset::footprint() const {
+  size_t bytes = fallback.capacity() * sizeof(double);
+  for (size_t level = 0; level < lows.size(); level++) {
+    bytes += (lows[level].capacity() + highs[level].capacity()) *
+             sizeof(double);
+  }
+  return bytes;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file environment.cpp
+ * @author Devin Arena
+ * @brief Implementation file for environment class.
+ * @since 10/19/2026
+ **/
+
+#include "../include/environment.hpp"
+
+/**
+ * @brief Default constructor, starts with no definitions.
+ */
+Environment::Environment() {}
+
+/**
+ * @brief Looks up a definition by name.
+ *
+ * @param name const std::string& the name to look up.
+ * @return int the index of the symbol or -1 if it is not defined.
+ */
+int Environment::resolve(const std::string& name) const {
+  for (size_t i = 0; i < symbols.size(); i++) {
+    if (symbols[i].name == name)
+      return i;
+  }
+  return -1;
+}
+
+/**
+ * @brief Defines (or redefines) a parameter. Symbol indices are stable, so
+ * compiled programs referencing the parameter pick up the new value without
+ * being recompiled.
+ *
+ * @param name const std::string& the name of the parameter.
+ * @param value double the value of the parameter.
+ * @param body const std::string& the expression the value was evaluated
+ * from, empty for a plain value.
+ * @param deps const std::vector<std::string>& the names the body references.
+ * @return int the index of the parameter.
+ */
+int Environment::defineParam(const std::string& name,
+                             double value,
+                             const std::string& body,
+                             const std::vector<std::string>& deps) {
+  int index = resolve(name);
+  if (index == -1) {
+    index = symbols.size();
+    symbols.push_back(Symbol{});
+    values.push_back(0);
+  }
+  symbols[index] = Symbol{name, SymbolKind::PARAM, value, "", body, deps};
+  values[index] = value;
+  return index;
+}
+
+/**
+ * @brief Defines (or redefines) a single argument function. The body is kept
+ * as source and scanned when a call to the function is inlined, so it always
+ * sees the latest definitions.
+ *
+ * @param name const std::string& the name of the function.
+ * @param arg const std::string& the name of the argument.
+ * @param body const std::string& the body of the function.
+ * @return int the index of the function.
+ */
+int Environment::defineFunction(const std::string& name,
+                                const std::string& arg,
+                                const std::string& body) {
+  int index = resolve(name);
+  if (index == -1) {
+    index = symbols.size();
+    symbols.push_back(Symbol{});
+    values.push_back(0);
+  }
+  symbols[index] = Symbol{name, SymbolKind::FUNC, 0, arg, body, {}};
+  values[index] = 0;
+  return index;
+}
+
+// Getters and Setters
+
+const Symbol& Environment::get(int index) const {
+  return symbols[index];
+}
+
+const double* Environment::getValues() const {
+  return values.data();
+}
+
+size_t Environment::size() const {
+  return symbols.size();
+}
@@ -0,0 +1,205 @@
+/**
+ * @file exporter.cpp
+ * @author Devin Arena
+ * @brief Implementation file for exporter class.
+ * @since 10/19/2026
+ **/
+
+#include "../include/exporter.hpp"
+#include "../include/tgraph.hpp"
+
+#ifdef TG_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+// bytes of formatted text collected before each write
+#define WRITE_BUFFER (1 << 20)
+// bytes of the output file mapped at a time
+#define MAP_WINDOW (64 << 20)
+// upper bound on the characters needed to print a double
+#define MAX_DOUBLE_CHARS 32
+
+/**
+ * @brief Default constructor.
+ *
+ * @param vm VM& the virtual machine used to evaluate programs.
+ */
+Exporter::Exporter(VM& vm) : vm(vm) {}
+
+/**
+ * @brief Evaluates one batch of the n evenly spaced samples between x0 and x1.
+ *
+ * @param program const std::vector<Operand>& the program to evaluate.
+ * @param x0 double the first x value.
+ * @param x1 double the last x value.
+ * @param n size_t the total number of samples.
+ * @param first size_t the index of the first sample in this batch.
+ * @param count size_t the number of samples in this batch, at most VM_BATCH.
+ * @param xs double* receives the x values.
+ * @param ys double* receives the results, one row per x.
+ * @return size_t the number of results per x.
+ */
+size_t Exporter::sampleBatch(const std::vector<Operand>& program,
+                             double x0,
+                             double x1,
+                             size_t n,
+                             size_t first,
+                             size_t count,
+                             double* xs,
+                             double* ys) {
+  double step = n > 1 ? (x1 - x0) / (n - 1) : 0;
+  for (size_t k = 0; k < count; k++) {
+    xs[k] = x0 + step * (first + k);
+  }
+  return vm.runBatch(program, xs, count, ys);
+}
+
+/**
+ * @brief Writes samples as CSV rows of x followed by each result. Rows are
+ * formatted into a large buffer which is written whenever it fills up.
+ *
+ * @param program const std::vector<Operand>& the program to evaluate.
+ * @param x0 double the first x value.
+ * @param x1 double the last x value.
+ * @param n size_t the number of samples.
+ * @param filename const std::string& the file to write.
+ * @return bool true if the file was written.
+ */
+bool Exporter::writeCSV(const std::vector<Operand>& program,
+                        double x0,
+                        double x1,
+                        size_t n,
+                        const std::string& filename) {
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  size_t results = VM::results(program);
+  size_t row = (results + 1) * MAX_DOUBLE_CHARS;
+  std::vector<char> buffer(WRITE_BUFFER);
+  std::vector<double> ys(VM_BATCH * results);
+  double xs[VM_BATCH];
+
+  char* end = buffer.data() + buffer.size();
+  char* p = buffer.data();
+  p += snprintf(p, row, "x");
+  for (size_t r = 0; r < results; r++) {
+    p += snprintf(p, row, results == 1 ? ",y" : ",y%zu", r + 1);
+  }
+  *p++ = '\n';
+
+  for (size_t first = 0; first < n; first += VM_BATCH) {
+    size_t count = std::min<size_t>(VM_BATCH, n - first);
+    sampleBatch(program, x0, x1, n, first, count, xs, ys.data());
+    for (size_t k = 0; k < count; k++) {
+      if ((size_t)(end - p) < row) {
+        fwrite(buffer.data(), 1, p - buffer.data(), file);
+        p = buffer.data();
+      }
+      p = std::to_chars(p, end, xs[k]).ptr;
+      for (size_t r = 0; r < results; r++) {
+        *p++ = ',';
+        p = std::to_chars(p, end, ys[k * results + r]).ptr;
+      }
+      *p++ = '\n';
+    }
+  }
+  fwrite(buffer.data(), 1, p - buffer.data(), file);
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
+
+/**
+ * @brief Writes samples as raw native float64 records of x followed by each
+ * result. On Linux and macOS the file is sized up front and filled through a
+ * sliding memory mapped window, elsewhere it is written in large blocks.
+ *
+ * @param program const std::vector<Operand>& the program to evaluate.
+ * @param x0 double the first x value.
+ * @param x1 double the last x value.
+ * @param n size_t the number of samples.
+ * @param filename const std::string& the file to write.
+ * @return bool true if the file was written.
+ */
+bool Exporter::writeF64(const std::vector<Operand>& program,
+                        double x0,
+                        double x1,
+                        size_t n,
+                        const std::string& filename) {
+  size_t results = VM::results(program);
+  size_t record = (results + 1) * sizeof(double);
+  std::vector<double> ys(VM_BATCH * results);
+  std::vector<double> records(VM_BATCH * (results + 1));
+  double xs[VM_BATCH];
+
+#ifdef TG_LINUX
+  int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return false;
+  size_t size = n * record;
+  if (ftruncate(fd, size) != 0) {
+    close(fd);
+    return false;
+  }
+  char* window = nullptr;
+  size_t windowStart = 0;
+  size_t windowSize = 0;
+  size_t offset = 0;
+#else
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER);
+#endif
+
+  for (size_t first = 0; first < n; first += VM_BATCH) {
+    size_t count = std::min<size_t>(VM_BATCH, n - first);
+    sampleBatch(program, x0, x1, n, first, count, xs, ys.data());
+    for (size_t k = 0; k < count; k++) {
+      double* rec = &records[k * (results + 1)];
+      rec[0] = xs[k];
+      std::memcpy(rec + 1, &ys[k * results], results * sizeof(double));
+    }
+#ifdef TG_LINUX
+    const char* src = (const char*)records.data();
+    size_t left = count * record;
+    while (left > 0) {
+      if (window == nullptr || offset >= windowStart + windowSize) {
+        if (window != nullptr)
+          munmap(window, windowSize);
+        windowStart = offset - offset % MAP_WINDOW;
+        windowSize = std::min<size_t>(MAP_WINDOW, size - windowStart);
+        window = (char*)mmap(nullptr, windowSize, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, windowStart);
+        if (window == MAP_FAILED) {
+          close(fd);
+          return false;
+        }
+      }
+      size_t chunk = std::min(left, windowStart + windowSize - offset);
+      std::memcpy(window + (offset - windowStart), src, chunk);
+      offset += chunk;
+      src += chunk;
+      left -= chunk;
+    }
+#else
+    fwrite(records.data(), record, count, file);
+#endif
+  }
+
+#ifdef TG_LINUX
+  if (window != nullptr)
+    munmap(window, windowSize);
+  return close(fd) == 0;
+#else
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+#endif
+}
@@ -0,0 +1,230 @@
+/**
+ * @file field.cpp
+ * @author Devin Arena
+ * @brief Implementation file for fields of x and y.
+ * @since 10/19/2026
+ **/
+
+#include "../include/field.hpp"
+#include "../include/opcodes.hpp"
+#include "../include/parallel.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+/**
+ * @brief Default constructor, the field has no program until setProgram.
+ *
+ * @param kind FieldKind how the field is drawn.
+ * @param expression const std::string& the source of the expression.
+ * @param env const Environment* parameter values, may be null.
+ */
+Field::Field(FieldKind kind,
+             const std::string& expression,
+             const Environment* env)
+    : kind(kind),
+      expression(expression),
+      columns(0),
+      rows(0),
+      low(0),
+      high(0),
+      vms(workerCount(), VM(env)),
+      outs(workerCount()) {}
+
+/**
+ * @brief Sets the compiled expression.
+ *
+ * @param program const std::vector<Operand>& the program computing the field.
+ * @param deps const std::vector<std::string>& the user-definable names it
+ * depends on.
+ */
+void Field::setProgram(const std::vector<Operand>& program,
+                       const std::vector<std::string>& deps) {
+  this->program = program;
+  this->deps = deps;
+}
+
+/**
+ * @brief Evaluates the field on a grid, split into tiles evaluated across
+ * worker threads in batches. Only the first result is kept if the expression
+ * has several (+/-).
+ *
+ * @param left double the x value of the first column.
+ * @param top double the y value of the first row.
+ * @param stepX double the x distance between columns.
+ * @param stepY double the y distance between rows, going down.
+ * @param columns int the columns of the grid.
+ * @param rows int the rows of the grid.
+ * @param cancelled const std::function<bool()>& checked before each tile,
+ * returns true to abandon the evaluation.
+ * @return bool false if the evaluation was abandoned.
+ */
+bool Field::sample(double left,
+                   double top,
+                   double stepX,
+                   double stepY,
+                   int columns,
+                   int rows,
+                   const std::function<bool()>& cancelled) {
+  this->columns = columns;
+  this->rows = rows;
+  values.resize((size_t)columns * rows);
+  size_t stride = VM::results(program);
+  int tilesX = (columns + FIELD_TILE_W - 1) / FIELD_TILE_W;
+  int tilesY = (rows + FIELD_TILE_H - 1) / FIELD_TILE_H;
+  std::atomic<bool> abandoned{false};
+  parallelFor((size_t)tilesX * tilesY, [&](unsigned worker, size_t t) {
+    if (abandoned.load(std::memory_order_relaxed) || cancelled()) {
+      abandoned = true;
+      return;
+    }
+    int x0 = t % tilesX * FIELD_TILE_W;
+    int y0 = t / tilesX * FIELD_TILE_H;
+    int w = std::min(FIELD_TILE_W, columns - x0);
+    int h = std::min(FIELD_TILE_H, rows - y0);
+    std::vector<double>& out = outs[worker];
+    out.resize(VM_BATCH * stride);
+    double xs[VM_BATCH];
+    double ys[VM_BATCH];
+    // VM_BATCH values at a time, a few rows of the tile per batch
+    for (int p = 0; p < w * h; p += VM_BATCH) {
+      int n = std::min(VM_BATCH, w * h - p);
+      for (int k = 0; k < n; k++) {
+        xs[k] = left + (x0 + (p + k) % w) * stepX;
+        ys[k] = top - (y0 + (p + k) / w) * stepY;
+      }
+      vms[worker].runBatch(program, xs, n, out.data(), 0, ys);
+      for (int k = 0; k < n; k++) {
+        values[(size_t)(y0 + (p + k) / w) * columns + x0 + (p + k) % w] =
+            out[k * stride];
+      }
+    }
+  });
+  if (abandoned)
+    return false;
+
+  low = INFINITY;
+  high = -INFINITY;
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < columns; c++) {
+      double v = value(c, r);
+      if (std::isnan(v))
+        continue;
+      low = std::min(low, v);
+      high = std::max(high, v);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Gets a sampled value.
+ *
+ * @param column int the column of the grid.
+ * @param row int the row of the grid.
+ * @return double the value, NaN if it is undefined there.
+ */
+double Field::value(int column, int row) const {
+  double v = values[(size_t)row * columns + column];
+  if (!std::isfinite(v) || v == INT_MIN || v == INT_MAX)
+    return NAN;
+  return v;
+}
+
+/**
+ * @brief Classifies the square between four neighbouring grid values for
+ * marching squares: which corners are above zero, top left, top right, bottom
+ * right and bottom left from the highest bit.
+ *
+ * @param column int the column of the top left corner.
+ * @param row int the row of the top left corner.
+ * @return int the case, 0 if the zero contour does not cross the square (or a
+ * corner is undefined).
+ */
+int Field::crossing(int column, int row) const {
+  double corners[4] = {value(column, row), value(column + 1, row),
+                       value(column + 1, row + 1), value(column, row + 1)};
+  int bits = 0;
+  for (double corner : corners) {
+    if (std::isnan(corner))
+      return 0;
+    bits = bits << 1 | (corner > 0);
+  }
+  return bits == 15 ? 0 : bits;
+}
+
+/**
+ * @brief Gets the glyph following the contour through a square, a corner cut
+ * off is a diagonal and a saddle crosses.
+ *
+ * @param crossing int the marching squares case, see crossing.
+ * @return char the glyph, a space if the contour does not cross.
+ */
+char Field::contourGlyph(int crossing) {
+  static const char glyphs[] = " \\/-\\X|//|X\\-/\\ ";
+  return glyphs[crossing];
+}
+
+/**
+ * @brief Gets the glyph shading a sampled value between the lowest and the
+ * highest value on the grid.
+ *
+ * @param column int the column of the grid.
+ * @param row int the row of the grid.
+ * @return char the shade, a space if the value is undefined.
+ */
+char Field::shade(int column, int row) const {
+  static const int shades = std::strlen(FIELD_SHADES);
+  double v = value(column, row);
+  if (std::isnan(v))
+    return ' ';
+  int level = high > low ? std::lround((v - low) / (high - low) * (shades - 1))
+                         : (shades - 1) / 2;
+  return FIELD_SHADES[level];
+}
+
+// Getters and Setters
+
+/**
+ * @brief Gets how the field is drawn.
+ *
+ * @return FieldKind the kind of plot.
+ */
+FieldKind Field::getKind() const {
+  return kind;
+}
+
+/**
+ * @brief Gets the source of the expression.
+ *
+ * @return const std::string& the expression.
+ */
+const std::string& Field::getExpression() const {
+  return expression;
+}
+
+/**
+ * @brief Gets the user-definable names the expression depends on.
+ *
+ * @return const std::vector<std::string>& the names.
+ */
+const std::vector<std::string>& Field::getDeps() const {
+  return deps;
+}
+
+/**
+ * @brief Gets the memory held by the program, the grid and the workers.
+ *
+ * @return size_t the size in bytes.
+ */
+size_t Field::footprint() const {
+  size_t bytes = program.capacity() * sizeof(Operand) +
+                 values.capacity() * sizeof(double) +
+                 vms.capacity() * sizeof(VM);
+  for (size_t w = 0; w < vms.size(); w++) {
+    bytes += vms[w].footprint() + outs[w].capacity() * sizeof(double);
+  }
+  return bytes;
+}
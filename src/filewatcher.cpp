@@ -0,0 +1,143 @@
+/**
+ * @file filewatcher.cpp
+ * @author Devin Arena
+ * @brief Implementation file for watching a file for changes.
+ * @since 10/19/2026
+ **/
+
+#include "../include/filewatcher.hpp"
+
+// inotify is only on Linux, other platforms poll the modification time
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#include <sys/stat.h>
+
+/**
+ * @brief Default constructor, nothing is watched until open.
+ */
+FileWatcher::FileWatcher() : fd(-1), watch(-1), mtime(0), size(0) {}
+
+/**
+ * @brief Destructor, stops watching.
+ */
+FileWatcher::~FileWatcher() {
+  close();
+}
+
+/**
+ * @brief Gets the modification time and size of the file.
+ *
+ * @param mtime long long& receives the modification time, in seconds.
+ * @param size long long& receives the size in bytes.
+ * @return bool false if the file does not exist.
+ */
+bool FileWatcher::stamp(long long& mtime, long long& size) const {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0)
+    return false;
+  mtime = (long long)info.st_mtime;
+  size = (long long)info.st_size;
+  return true;
+}
+
+/**
+ * @brief Starts watching a file, replacing the one watched before.
+ *
+ * @param path const std::string& the file to watch.
+ * @return bool false if the file does not exist.
+ */
+bool FileWatcher::open(const std::string& path) {
+  close();
+  this->path = path;
+  if (!stamp(mtime, size)) {
+    this->path.clear();
+    return false;
+  }
+  size_t slash = path.find_last_of('/');
+  name = slash == std::string::npos ? path : path.substr(slash + 1);
+#ifdef __linux__
+  std::string directory = slash == std::string::npos ? "."
+                          : slash == 0               ? "/"
+                                                     : path.substr(0, slash);
+  fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd >= 0) {
+    watch = inotify_add_watch(fd, directory.c_str(),
+                              IN_CLOSE_WRITE | IN_MOVED_TO);
+    // polling still works without a watch
+    if (watch < 0) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+#endif
+  return true;
+}
+
+/**
+ * @brief Stops watching the file.
+ */
+void FileWatcher::close() {
+#ifdef __linux__
+  if (fd >= 0)
+    ::close(fd);
+#endif
+  fd = -1;
+  watch = -1;
+  path.clear();
+}
+
+/**
+ * @brief Checks if the file was written (or replaced) since the last check,
+ * without blocking. Polling only notices changes to the modification time
+ * (to the second) or the size.
+ *
+ * @return bool true if it changed.
+ */
+bool FileWatcher::changed() {
+  if (path.empty())
+    return false;
+#ifdef __linux__
+  if (fd >= 0) {
+    bool written = false;
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+      for (ssize_t i = 0; i < length;) {
+        const inotify_event* event = (const inotify_event*)&buffer[i];
+        if (event->len > 0 && name == event->name)
+          written = true;
+        i += sizeof(inotify_event) + event->len;
+      }
+    }
+    return written;
+  }
+#endif
+  long long nowMtime, nowSize;
+  if (!stamp(nowMtime, nowSize) || (nowMtime == mtime && nowSize == size))
+    return false;
+  mtime = nowMtime;
+  size = nowSize;
+  return true;
+}
+
+// Getters and Setters
+
+/**
+ * @brief Checks if a file is being watched.
+ *
+ * @return bool true if it is.
+ */
+bool FileWatcher::isOpen() const {
+  return !path.empty();
+}
+
+/**
+ * @brief Gets the path of the watched file.
+ *
+ * @return const std::string& the path, empty if none.
+ */
+const std::string& FileWatcher::getPath() const {
+  return path;
+}
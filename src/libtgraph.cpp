@@ -0,0 +1,140 @@
+/**
+ * @file libtgraph.cpp
+ * @author Devin Arena
+ * @brief Implementation file for the libtgraph C API.
+ * @since 10/19/2026
+ **/
+
+#include "../include/libtgraph.h"
+#include "../include/opcodes.hpp"
+#include "../include/optimizer.hpp"
+#include "../include/parser.hpp"
+#include "../include/plot.hpp"
+#include "../include/scanner.hpp"
+#include "../include/vm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct tg_program {
+  std::vector<Operand> ops;
+  size_t results;
+};
+
+tg_program* tg_compile(const char* expression) {
+  if (expression == nullptr)
+    return nullptr;
+  std::string source{expression};
+  Scanner scanner;
+  Parser parser;
+  std::vector<Token> tokens = scanner.scan(source);
+  if (scanner.hadError() || tokens.empty())
+    return nullptr;
+  std::vector<Operand> ops = parser.parse(tokens);
+  if (parser.hadError())
+    return nullptr;
+  ops = Optimizer().polynomials(ops);
+  size_t results = VM::results(ops);
+  return new tg_program{std::move(ops), results};
+}
+
+size_t tg_results(const tg_program* program) {
+  return program ? program->results : 0;
+}
+
+int tg_eval(const tg_program* program,
+            const double* xs,
+            size_t xstride,
+            double* ys,
+            size_t ystride,
+            size_t n) {
+  if (program == nullptr || xs == nullptr || ys == nullptr ||
+      ystride < program->results)
+    return -1;
+  VM vm;
+  double batch[VM_BATCH];
+  std::vector<double> out(VM_BATCH * program->results);
+  for (size_t first = 0; first < n; first += VM_BATCH) {
+    size_t count = std::min<size_t>(VM_BATCH, n - first);
+    for (size_t k = 0; k < count; k++) {
+      batch[k] = xs[(first + k) * xstride];
+    }
+    vm.runBatch(program->ops, batch, count, out.data());
+    for (size_t k = 0; k < count; k++) {
+      std::memcpy(ys + (first + k) * ystride, &out[k * program->results],
+                  program->results * sizeof(double));
+    }
+  }
+  return 0;
+}
+
+int tg_render(const tg_program* const* programs,
+              size_t count,
+              double xstep,
+              double ystep,
+              char* buffer,
+              int width,
+              int height) {
+  return tg_render_view(programs, count, xstep, ystep, 0, 0, buffer, width,
+                        height);
+}
+
+int tg_render_view(const tg_program* const* programs,
+                   size_t count,
+                   double xstep,
+                   double ystep,
+                   double originx,
+                   double originy,
+                   char* buffer,
+                   int width,
+                   int height) {
+  if ((programs == nullptr && count > 0) || buffer == nullptr || width <= 0 ||
+      height <= 0 || !std::isfinite(xstep) || !std::isfinite(ystep) ||
+      xstep == 0 || ystep == 0 || !std::isfinite(originx) ||
+      !std::isfinite(originy))
+    return -1;
+  // the axes are off screen long before the offset of the origin in cells
+  // would overflow an int
+  int panX = std::lround(std::clamp(originx / xstep, -1e9, 1e9));
+  int panY = std::lround(std::clamp(originy / ystep, -1e9, 1e9));
+  std::memset(buffer, ' ', (size_t)width * height);
+  VM vm;
+  double xs[VM_BATCH];
+  std::vector<double> out;
+  for (size_t e = 0; e < count; e++) {
+    const tg_program* program = programs[e];
+    if (program == nullptr)
+      return -1;
+    out.resize(VM_BATCH * program->results);
+    for (int i = 0; i < width; i += VM_BATCH) {
+      int n = std::min(VM_BATCH, width - i);
+      for (int k = 0; k < n; k++) {
+        xs[k] = plotX(i + k, width, xstep, originx);
+      }
+      vm.runBatch(program->ops, xs, n, out.data());
+      for (int k = 0; k < n; k++) {
+        for (size_t r = 0; r < program->results; r++) {
+          int row = plotRow(out[k * program->results + r], height, ystep,
+                            originy);
+          if (row != -1)
+            buffer[(size_t)row * width + i + k] = plotSymbol(e);
+        }
+      }
+    }
+  }
+  for (int j = 0; j < height; j++) {
+    for (int i = 0; i < width; i++) {
+      char& cell = buffer[(size_t)j * width + i];
+      if (cell == ' ')
+        cell = axisGlyph(i, j, width, height, panX, panY);
+    }
+  }
+  return 0;
+}
+
+void tg_free(tg_program* program) {
+  delete program;
+}
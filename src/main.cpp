@@ -6,11 +6,14 @@
  * @since 7/19/2022
  **/
 
+#include <stdlib.h>
 #include <string.h>
 #include <iostream>
 #include <string>
 
+#include "../include/server.hpp"
 #include "../include/tgraph.hpp"
+#include "../include/tracer.hpp"
 
 /**
  * @brief Parses command line arguments. If given equations, graphs them and
@@ -21,7 +24,46 @@
  * @return int exit code for the program
  */
 int main(int argc, char** argv) {
+  // server mode never touches the terminal, so check for it first
+  if (argc > 2 && strcmp(argv[1], "--serve") == 0) {
+    return Server(argv[2]).run();
+  }
+  // start tracing before anything else so startup is traced too
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--trace") == 0 &&
+        !Tracer::instance().open(argv[i + 1])) {
+      std::cout << "Could not open trace file: " << argv[i + 1] << "\n";
+      return 1;
+    }
+  }
+  // replay a recorded session without a terminal instead of opening the cli
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--replay") != 0)
+      continue;
+    // as recorded unless sped up, "max" runs the commands back to back
+    double speed = 1.0;
+    for (int j = 1; j + 1 < argc; j++) {
+      if (strcmp(argv[j], "--speed") != 0)
+        continue;
+      bool max = strcmp(argv[j + 1], "max") == 0;
+      speed = max ? 0.0 : atof(argv[j + 1]);
+      if (!max && speed <= 0) {
+        std::cout << "Invalid replay speed: " << argv[j + 1] << "\n";
+        return 1;
+      }
+    }
+    TGraph tG(true);
+    return tG.replay(argv[i + 1], speed);
+  }
   TGraph tG;
+  // record from the start so equations given as arguments are recorded too
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--record") == 0 && !tG.record(argv[i + 1])) {
+      std::cout << "Could not open session file: " << argv[i + 1] << "\n";
+      return 1;
+    }
+  }
+  bool stream = false;
   // Parse command line arguments before starting cli if necessary
   if (argc > 1) {
     std::string equation{""};
@@ -32,6 +74,17 @@ int main(int argc, char** argv) {
         equation = "";
         continue;
       }
+      // already handled above
+      if (strcmp(argv[i], "--trace") == 0 ||
+          strcmp(argv[i], "--record") == 0) {
+        i++;
+        continue;
+      }
+      // plot samples from stdin instead of opening the cli
+      if (strcmp(argv[i], "--stream") == 0) {
+        stream = true;
+        continue;
+      }
       // special for info command
       if (strcmp(argv[i], "-info") == 0) {
         std::cout << "TGraph v" << VERSION_MAJOR << "." << VERSION_MINOR
@@ -50,6 +103,10 @@ int main(int argc, char** argv) {
       tG.parseInput(equation);
     }
   }
+  if (stream) {
+    tG.stream();
+    return 0;
+  }
   // start the cli
   tG.cli();
   return 0;
@@ -0,0 +1,439 @@
+/**
+ * @file optimizer.cpp
+ * @author Devin Arena
+ * @brief Implementation file for optimizer class.
+ * @since 10/19/2026
+ **/
+
+#include "../include/optimizer.hpp"
+#include "../include/builtins.hpp"
+#include "../include/opcodes.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+/**
+ * @brief Multiplies two polynomials.
+ *
+ * @param a const std::vector<double>& coefficients, lowest degree first.
+ * @param b const std::vector<double>& coefficients, lowest degree first.
+ * @return std::vector<double> the coefficients of the product.
+ */
+static std::vector<double> multiply(const std::vector<double>& a,
+                                    const std::vector<double>& b) {
+  std::vector<double> product(a.size() + b.size() - 1, 0.0);
+  for (size_t i = 0; i < a.size(); i++) {
+    for (size_t j = 0; j < b.size(); j++)
+      product[i + j] += a[i] * b[j];
+  }
+  return product;
+}
+
+/**
+ * @brief Checks if a polynomial has at most one term, c*x^k.
+ *
+ * @param a const std::vector<double>& coefficients, lowest degree first.
+ * @return bool true if at most one coefficient is not 0.
+ */
+static bool monomial(const std::vector<double>& a) {
+  return std::count_if(a.begin(), a.end(), [](double c) { return c != 0; }) <=
+         1;
+}
+
+/**
+ * @brief Default constructor.
+ */
+Optimizer::Optimizer() {}
+
+/**
+ * @brief Turns a symbolic stack entry back into opcodes. Entries that do not
+ * depend on the animated parameter are moved into their own program and
+ * replaced by a CACHED load, unless they are a single load already (including
+ * a CACHED load of an earlier slot, negated or not).
+ *
+ * @param entry Entry& the entry to materialize.
+ * @param hoisted std::vector<std::vector<Operand>>& the hoisted programs.
+ * @return std::vector<Operand> the opcodes computing the entry.
+ */
+std::vector<Operand> Optimizer::materialize(
+    Entry& entry,
+    std::vector<std::vector<Operand>>& hoisted) {
+  if (entry.variant)
+    return entry.code;
+  OP op = entry.code[0].opcode;
+  bool operand = op == OP::CONST || op == OP::PARAM || op == OP::CACHED;
+  bool load = operand || op == OP::VAR || op == OP::VAR_Y;
+  if (load && entry.code.size() == (operand ? 2u : 1u))
+    return entry.code;
+  // the negated copy made by +/- negates its cached load per frame
+  if (op == OP::CACHED && entry.code.size() == 3 &&
+      entry.code[2].opcode == OP::NEG)
+    return entry.code;
+  std::vector<Operand> cached{OPCODE(OP::CACHED), INDEX((int)hoisted.size())};
+  hoisted.push_back(entry.code);
+  return cached;
+}
+
+/**
+ * @brief Splits a program for animating a parameter. Every maximal
+ * subexpression that only depends on x (and parameters that are not animated)
+ * is appended to hoisted so it can be evaluated once per column, the returned
+ * residual program loads it with CACHED and only computes the rest per frame.
+ *
+ * @param program std::vector<Operand>& the program to split.
+ * @param param int the index of the animated parameter.
+ * @param hoisted std::vector<std::vector<Operand>>& receives the hoisted
+ * programs, CACHED slots index into it.
+ * @return std::vector<Operand> the residual program.
+ */
+std::vector<Operand> Optimizer::hoist(
+    std::vector<Operand>& program,
+    int param,
+    std::vector<std::vector<Operand>>& hoisted) {
+  std::vector<Entry> stack;
+  // applies an operation to the top count entries, hoisting the invariant
+  // ones when any of them vary
+  auto combine = [&](size_t count, OP op) {
+    auto first = stack.end() - count;
+    bool variant = false;
+    for (auto it = first; it != stack.end(); it++) {
+      variant = variant || it->variant;
+    }
+    Entry& a = *first;
+    if (!variant) {
+      for (auto it = first + 1; it != stack.end(); it++) {
+        a.code.insert(a.code.end(), it->code.begin(), it->code.end());
+      }
+    } else {
+      a.code = materialize(a, hoisted);
+      for (auto it = first + 1; it != stack.end(); it++) {
+        std::vector<Operand> right = materialize(*it, hoisted);
+        a.code.insert(a.code.end(), right.begin(), right.end());
+      }
+      a.variant = true;
+    }
+    a.code.push_back(OPCODE(op));
+    stack.erase(first + 1, stack.end());
+  };
+  for (size_t i = 0; i < program.size(); i++) {
+    OP op = program[i].opcode;
+    switch (op) {
+      case OP::CONST:
+      case OP::PARAM: {
+        Operand operand = program[++i];
+        bool variant = op == OP::PARAM && operand.index == param;
+        stack.push_back(Entry{{OPCODE(op), operand}, variant});
+        break;
+      }
+      case OP::VAR:
+      case OP::VAR_Y: {
+        stack.push_back(Entry{{OPCODE(op)}, false});
+        break;
+      }
+      case OP::POLY: {
+        // a polynomial of x is only invariant, like x itself
+        size_t length = 3 + program[i + 1].index + program[i + 2].index;
+        stack.push_back(Entry{
+            {program.begin() + i, program.begin() + i + length}, false});
+        i += length - 1;
+        break;
+      }
+      case OP::NEG:
+      case OP::MAGIC: {
+        stack.back().code.push_back(OPCODE(op));
+        break;
+      }
+      case OP::PLUS_OR_MINUS: {
+        // an invariant value is hoisted once and the copy negates its cached
+        // load, rather than hoisting the same subexpression twice
+        if (!stack.back().variant)
+          stack.back().code = materialize(stack.back(), hoisted);
+        // the positive value stays below the negated copy on the stack
+        Entry negated = stack.back();
+        negated.code.push_back(OPCODE(OP::NEG));
+        stack.push_back(negated);
+        break;
+      }
+      case OP::ADD:
+      case OP::SUB:
+      case OP::MUL:
+      case OP::DIV:
+      case OP::POW:
+      case OP::LESS:
+      case OP::LESS_EQUAL:
+      case OP::GREATER:
+      case OP::GREATER_EQUAL:
+      case OP::EQUAL:
+      case OP::NOT_EQUAL: {
+        combine(2, op);
+        break;
+      }
+      case OP::SELECT: {
+        combine(3, op);
+        break;
+      }
+      default: {
+        const Builtin* function = builtin(op);
+        if (function == nullptr) {
+          std::cerr << "Cannot hoist operation: " << +op << "\n";
+          return program;
+        }
+        combine(function->arity, op);
+        break;
+      }
+    }
+  }
+  std::vector<Operand> residual;
+  for (Entry& entry : stack) {
+    std::vector<Operand> code = materialize(entry, hoisted);
+    residual.insert(residual.end(), code.begin(), code.end());
+  }
+  return residual;
+}
+
+/**
+ * @brief Turns an entry of the polynomial pass back into opcodes. Polynomials
+ * (and ratios of them) become a single POLY, constant ones a single CONST.
+ *
+ * @param term Term& the entry to materialize.
+ * @return std::vector<Operand> the opcodes computing the entry.
+ */
+std::vector<Operand> Optimizer::materialize(Term& term) {
+  if (!term.polynomial)
+    return term.code;
+  if (term.den.empty() && term.num.size() == 1) {
+    if (term.code.size() <= 2)
+      return term.code;
+    return {OPCODE(OP::CONST), VALUE(term.num[0])};
+  }
+  // x on its own
+  if (term.den.empty() && term.code.size() == 1)
+    return term.code;
+  // Horner's rule starts from the highest degree
+  std::vector<Operand> poly{OPCODE(OP::POLY), INDEX((int)term.num.size()),
+                            INDEX((int)term.den.size())};
+  for (auto it = term.num.rbegin(); it != term.num.rend(); it++) {
+    poly.push_back(VALUE(*it));
+  }
+  for (auto it = term.den.rbegin(); it != term.den.rend(); it++) {
+    poly.push_back(VALUE(*it));
+  }
+  return poly;
+}
+
+/**
+ * @brief Applies a binary operation to two polynomials, if the result is a
+ * polynomial of at most POLY_MAX_DEGREE (or, for division, a ratio of two).
+ * Division by a constant 0 is left to DIV. Products and powers are only
+ * expanded when a factor is a single term c*x^k: multiplying out e.g.
+ * (x - 100)^8 gives coefficients so large that their sum cancels away every
+ * digit near x = 100, so those stay a MUL or POW of POLY operands.
+ *
+ * @param op OP the operation.
+ * @param a Term& the left operand, receives the result.
+ * @param b const Term& the right operand.
+ * @return bool false if a is unchanged because the result is not one.
+ */
+bool Optimizer::combine(OP op, Term& a, const Term& b) {
+  if (!a.polynomial || !b.polynomial || !a.den.empty() || !b.den.empty())
+    return false;
+  size_t degree = a.num.size() - 1;
+  switch (op) {
+    case OP::ADD:
+    case OP::SUB: {
+      if (a.num.size() < b.num.size())
+        a.num.resize(b.num.size(), 0.0);
+      for (size_t i = 0; i < b.num.size(); i++)
+        a.num[i] += op == OP::ADD ? b.num[i] : -b.num[i];
+      break;
+    }
+    case OP::MUL: {
+      if (degree + b.num.size() - 1 > POLY_MAX_DEGREE ||
+          (!monomial(a.num) && !monomial(b.num)))
+        return false;
+      a.num = multiply(a.num, b.num);
+      break;
+    }
+    case OP::DIV: {
+      if (b.num.size() > 1) {
+        a.den = b.num;
+        break;
+      }
+      if (b.num[0] == 0)
+        return false;
+      for (double& c : a.num) {
+        c /= b.num[0];
+      }
+      break;
+    }
+    case OP::POW: {
+      double exponent = b.num.size() == 1 ? b.num[0] : -1;
+      if (exponent < 0 || exponent != std::floor(exponent))
+        return false;
+      if (degree == 0) {
+        a.num[0] = std::pow(a.num[0], exponent);
+        break;
+      }
+      if (degree * exponent > POLY_MAX_DEGREE ||
+          (exponent > 1 && !monomial(a.num)))
+        return false;
+      std::vector<double> power{1.0};
+      for (int k = 0; k < (int)exponent; k++) {
+        power = multiply(power, a.num);
+      }
+      a.num = power;
+      break;
+    }
+    default:
+      return false;
+  }
+  // cancelled terms do not count towards the degree
+  while (a.num.size() > 1 && a.num.back() == 0)
+    a.num.pop_back();
+  return true;
+}
+
+/**
+ * @brief Finds the maximal subexpressions that are polynomials of x, or ratios
+ * of two, and replaces each with one POLY evaluated by Horner's rule, e.g.
+ * 3*x^3 - 2*x + 1 becomes three multiply-adds instead of two calls to pow.
+ * Constant subexpressions are folded into a CONST.
+ *
+ * @param program const std::vector<Operand>& the program to rewrite.
+ * @return std::vector<Operand> the rewritten program.
+ */
+std::vector<Operand> Optimizer::polynomials(
+    const std::vector<Operand>& program) {
+  std::vector<Term> stack;
+  // replaces the top count entries with one computed by the opcodes of each
+  auto opaque = [&](size_t count) {
+    auto first = stack.end() - count;
+    std::vector<Operand> code;
+    for (auto it = first; it != stack.end(); it++) {
+      std::vector<Operand> part = materialize(*it);
+      code.insert(code.end(), part.begin(), part.end());
+    }
+    stack.erase(first, stack.end());
+    stack.push_back(Term{code, {}, {}, false});
+  };
+  for (size_t i = 0; i < program.size(); i++) {
+    OP op = program[i].opcode;
+    switch (op) {
+      case OP::CONST: {
+        Operand value = program[++i];
+        stack.push_back(Term{{OPCODE(op), value}, {value.value}, {}, true});
+        break;
+      }
+      case OP::VAR: {
+        stack.push_back(Term{{OPCODE(op)}, {0.0, 1.0}, {}, true});
+        break;
+      }
+      case OP::VAR_Y: {
+        // polynomials are only recognized in x
+        stack.push_back(Term{{OPCODE(op)}, {}, {}, false});
+        break;
+      }
+      case OP::PARAM:
+      case OP::CACHED: {
+        Operand operand = program[++i];
+        stack.push_back(Term{{OPCODE(op), operand}, {}, {}, false});
+        break;
+      }
+      case OP::POLY: {
+        size_t length = 3 + program[i + 1].index + program[i + 2].index;
+        stack.push_back(Term{
+            {program.begin() + i, program.begin() + i + length}, {}, {}, false});
+        i += length - 1;
+        break;
+      }
+      case OP::NEG: {
+        Term& a = stack.back();
+        if (a.polynomial) {
+          for (double& c : a.num) {
+            c = -c;
+          }
+        }
+        a.code.push_back(OPCODE(op));
+        break;
+      }
+      case OP::PLUS_OR_MINUS: {
+        // the negated copy is pushed by the same opcodes, so it has none
+        opaque(1);
+        stack.back().code.push_back(OPCODE(op));
+        stack.push_back(Term{{}, {}, {}, false});
+        break;
+      }
+      case OP::MAGIC: {
+        opaque(1);
+        stack.back().code.push_back(OPCODE(op));
+        break;
+      }
+      case OP::ADD:
+      case OP::SUB:
+      case OP::MUL:
+      case OP::DIV:
+      case OP::POW: {
+        Term b = stack.back();
+        stack.pop_back();
+        Term& a = stack.back();
+        if (combine(op, a, b)) {
+          a.code.insert(a.code.end(), b.code.begin(), b.code.end());
+          a.code.push_back(OPCODE(op));
+          break;
+        }
+        stack.push_back(b);
+        opaque(2);
+        stack.back().code.push_back(OPCODE(op));
+        break;
+      }
+      case OP::LESS:
+      case OP::LESS_EQUAL:
+      case OP::GREATER:
+      case OP::GREATER_EQUAL:
+      case OP::EQUAL:
+      case OP::NOT_EQUAL: {
+        opaque(2);
+        stack.back().code.push_back(OPCODE(op));
+        break;
+      }
+      case OP::SELECT: {
+        opaque(3);
+        stack.back().code.push_back(OPCODE(op));
+        break;
+      }
+      default: {
+        const Builtin* function = builtin(op);
+        if (function == nullptr) {
+          std::cerr << "Cannot optimize operation: " << +op << "\n";
+          return program;
+        }
+        // builtins of constants are folded, e.g. sqrt(2) or sin(pi / 4)
+        double args[3];
+        bool constant = true;
+        for (int j = 0; j < function->arity; j++) {
+          Term& arg = stack[stack.size() - function->arity + j];
+          constant = constant && arg.polynomial && arg.den.empty() &&
+                     arg.num.size() == 1;
+          if (constant)
+            args[j] = arg.num[0];
+        }
+        if (constant) {
+          double v = function->scalar(args);
+          stack.erase(stack.end() - function->arity, stack.end());
+          stack.push_back(Term{{OPCODE(OP::CONST), VALUE(v)}, {v}, {}, true});
+          break;
+        }
+        opaque(function->arity);
+        stack.back().code.push_back(OPCODE(op));
+        break;
+      }
+    }
+  }
+  std::vector<Operand> optimized;
+  for (Term& term : stack) {
+    std::vector<Operand> code = materialize(term);
+    optimized.insert(optimized.end(), code.begin(), code.end());
+  }
+  return optimized;
+}
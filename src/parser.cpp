@@ -7,40 +7,68 @@
  **/
 
 #include "../include/parser.hpp"
-#include "../include/tgraph.hpp"
+#include "../include/builtins.hpp"
+#include "../include/opcodes.hpp"
 
+#include <cctype>
 #include <iostream>
 #include <stack>
 
 /**
  * @brief Default constructor. Generates the parseRule table.
  *
- * @param tokens the list of tokens to parse.
+ * @param env const Environment* user definitions to inline, may be null.
  */
-Parser::Parser() : tindex(0) {
+Parser::Parser(const Environment* env)
+    : tindex(0), parseRules(), env(env), scanner(env), error(false) {
   parseRules[+TType::VAR] =
-      (ParseRule){.prefix = &variable, .precedence = Precedence::NONE};
+      (ParseRule){.prefix = &Parser::variable, .precedence = Precedence::NONE};
+  parseRules[+TType::VAR_Y] =
+      (ParseRule){.prefix = &Parser::variable, .precedence = Precedence::NONE};
   parseRules[+TType::CONST] =
-      (ParseRule){.prefix = &literal, .precedence = Precedence::NONE};
+      (ParseRule){.prefix = &Parser::literal, .precedence = Precedence::NONE};
   parseRules[+TType::ADD] =
-      (ParseRule){.infix = &binary, .precedence = Precedence::TERM};
-  parseRules[+TType::SUB] = (ParseRule){
-      .prefix = &unary, .infix = &binary, .precedence = Precedence::TERM};
+      (ParseRule){.infix = &Parser::binary, .precedence = Precedence::TERM};
+  parseRules[+TType::SUB] = (ParseRule){.prefix = &Parser::unary,
+                                        .infix = &Parser::binary,
+                                        .precedence = Precedence::TERM};
   parseRules[+TType::MUL] =
-      (ParseRule){.infix = &binary, .precedence = Precedence::FACTOR};
+      (ParseRule){.infix = &Parser::binary, .precedence = Precedence::FACTOR};
   parseRules[+TType::DIV] =
-      (ParseRule){.infix = &binary, .precedence = Precedence::FACTOR};
+      (ParseRule){.infix = &Parser::binary, .precedence = Precedence::FACTOR};
   parseRules[+TType::POW] =
-      (ParseRule){.infix = &binary, .precedence = Precedence::POWER};
+      (ParseRule){.infix = &Parser::binary, .precedence = Precedence::POWER};
   parseRules[+TType::P_O_M] =
-      (ParseRule){.prefix = &unary, .precedence = Precedence::UNARY};
+      (ParseRule){.prefix = &Parser::unary, .precedence = Precedence::UNARY};
   parseRules[+TType::MAGIC] =
-      (ParseRule){.prefix = &unary, .precedence = Precedence::UNARY};
+      (ParseRule){.prefix = &Parser::unary, .precedence = Precedence::UNARY};
+  parseRules[+TType::LESS] = (ParseRule){.infix = &Parser::binary,
+                                         .precedence = Precedence::COMPARISON};
+  parseRules[+TType::LESS_EQUAL] = (ParseRule){
+      .infix = &Parser::binary, .precedence = Precedence::COMPARISON};
+  parseRules[+TType::GREATER] = (ParseRule){
+      .infix = &Parser::binary, .precedence = Precedence::COMPARISON};
+  parseRules[+TType::GREATER_EQUAL] = (ParseRule){
+      .infix = &Parser::binary, .precedence = Precedence::COMPARISON};
+  parseRules[+TType::EQUAL] = (ParseRule){
+      .infix = &Parser::binary, .precedence = Precedence::COMPARISON};
+  parseRules[+TType::NOT_EQUAL] = (ParseRule){
+      .infix = &Parser::binary, .precedence = Precedence::COMPARISON};
+  parseRules[+TType::QUESTION] =
+      (ParseRule){.infix = &Parser::ternary, .precedence = Precedence::TERNARY};
+  parseRules[+TType::COLON] = (ParseRule){.precedence = Precedence::NONE};
+  parseRules[+TType::COMMA] = (ParseRule){.precedence = Precedence::NONE};
   parseRules[+TType::FUNC] =
-      (ParseRule){.prefix = &func, .precedence = Precedence::NONE};
+      (ParseRule){.prefix = &Parser::func, .precedence = Precedence::NONE};
+  parseRules[+TType::PARAM] =
+      (ParseRule){.prefix = &Parser::param, .precedence = Precedence::NONE};
+  parseRules[+TType::CALL] =
+      (ParseRule){.prefix = &Parser::call, .precedence = Precedence::NONE};
+  parseRules[+TType::ARG] =
+      (ParseRule){.prefix = &Parser::argument, .precedence = Precedence::NONE};
   parseRules[+TType::C_PAREN] = (ParseRule){.precedence = Precedence::NONE};
   parseRules[+TType::O_PAREN] =
-      (ParseRule){.prefix = &grouping, .precedence = Precedence::NONE};
+      (ParseRule){.prefix = &Parser::grouping, .precedence = Precedence::NONE};
 }
 
 /**
@@ -70,7 +98,7 @@ Token Parser::prevToken() {
  * @brief Base case for the Pratt Parser, all equations are expressions.
  */
 void Parser::expression() {
-  parsePrecedence(Precedence::TERM);
+  parsePrecedence(Precedence::TERNARY);
 }
 
 /**
@@ -79,28 +107,66 @@ void Parser::expression() {
 void Parser::grouping() {
   expression();
   if (currentToken().type != TType::C_PAREN) {
-    std::cerr << "Expected closing parenthesis.";
+    std::cerr << "Expected closing parenthesis.\n";
+    error = true;
   }
   tindex++;
 }
 
 /**
- * @brief Descent case for built-in functions (e.g. sin, cos)
+ * @brief Descent case for built-in functions (e.g. sin, min, clamp), which
+ * take the number of comma separated arguments given in BUILTINS and compile
+ * to their own opcodes.
  */
 void Parser::func() {
-  Token funptr = currentToken();
-  if (!funptr.fnptr) {
-    std::cerr << "Unexpected function call.";
+  OP op = (OP)currentToken().index;
+  int arity = builtin(op)->arity;
+  tindex++;
+  if (currentToken().type != TType::O_PAREN) {
+    std::cerr << "Expected opening parenthesis.\n";
+    error = true;
+    ops.push_back(OPCODE(OP::CONST));
+    ops.push_back(VALUE(0));
+    return;
+  }
+  tindex++;
+  for (int arg = 0; arg < arity; arg++) {
+    if (arg > 0) {
+      if (currentToken().type != TType::COMMA) {
+        std::cerr << "Expected " << arity << " arguments.\n";
+        error = true;
+        return;
+      }
+      tindex++;
+    }
+    expression();
   }
-  tindex += 2;  // skip this token and the opening parenthesis
-  expression();
   if (currentToken().type != TType::C_PAREN) {
-    std::cerr << "Expected closing parenthesis.";
+    std::cerr << "Expected closing parenthesis.\n";
+    error = true;
     return;
   }
   tindex++;
-  ops.push_back(OPCODE(OP::BUILTIN));
-  ops.push_back(FUNC(funptr.fnptr));
+  ops.push_back(OPCODE(op));
+}
+
+/**
+ * @brief Descent case for the conditional operator, cond ? a : b. Both
+ * branches are compiled and evaluated, SELECT then picks one per x.
+ */
+void Parser::ternary() {
+  // right associative, so a ? b : c ? d : e nests in the else branch
+  parsePrecedence(Precedence::TERNARY);
+  if (currentToken().type != TType::COLON) {
+    std::cerr << "Expected ':' in conditional.\n";
+    error = true;
+    ops.push_back(OPCODE(OP::CONST));
+    ops.push_back(VALUE(0));
+  } else {
+    tindex++;
+    parsePrecedence(Precedence::TERNARY);
+  }
+  ops.push_back(OPCODE(OP::SELECT));
 }
 
 /**
@@ -127,9 +193,27 @@ void Parser::binary() {
     case TType::POW:
       ops.push_back(OPCODE(OP::POW));
       break;
+    case TType::LESS:
+      ops.push_back(OPCODE(OP::LESS));
+      break;
+    case TType::LESS_EQUAL:
+      ops.push_back(OPCODE(OP::LESS_EQUAL));
+      break;
+    case TType::GREATER:
+      ops.push_back(OPCODE(OP::GREATER));
+      break;
+    case TType::GREATER_EQUAL:
+      ops.push_back(OPCODE(OP::GREATER_EQUAL));
+      break;
+    case TType::EQUAL:
+      ops.push_back(OPCODE(OP::EQUAL));
+      break;
+    case TType::NOT_EQUAL:
+      ops.push_back(OPCODE(OP::NOT_EQUAL));
+      break;
     default:
       std::cerr << "Error: Invalid binary operator\n";
-      exit(1);
+      error = true;
   }
 }
 
@@ -153,7 +237,7 @@ void Parser::unary() {
       break;
     default:
       std::cerr << "Invalid unary operator: " << +op.type << "\n";
-      exit(1);
+      error = true;
   }
 }
 
@@ -170,7 +254,71 @@ void Parser::literal() {
  * @brief Descent case for variables.
  */
 void Parser::variable() {
-  ops.push_back(OPCODE(OP::VAR));
+  bool y = prevToken().type == TType::VAR_Y;
+  ops.push_back(OPCODE(y ? OP::VAR_Y : OP::VAR));
+}
+
+/**
+ * @brief Descent case for user parameters, their value is read when the
+ * program runs so changing it does not require recompiling.
+ */
+void Parser::param() {
+  int index = currentToken().index;
+  ops.push_back(OPCODE(OP::PARAM));
+  ops.push_back(INDEX(index));
+  tindex++;
+}
+
+/**
+ * @brief Descent case for user function calls. The argument is compiled on its
+ * own and the body of the function is inlined with every use of the argument
+ * replaced by the compiled argument.
+ */
+void Parser::call() {
+  const Symbol& fn = env->get(currentToken().index);
+  tindex += 2;  // skip this token and the opening parenthesis
+  // compile the argument separately from the caller's opcodes
+  std::vector<Operand> caller = std::move(ops);
+  ops = std::vector<Operand>();
+  expression();
+  if (currentToken().type != TType::C_PAREN) {
+    std::cerr << "Expected closing parenthesis.\n";
+    error = true;
+    return;
+  }
+  tindex++;
+  std::vector<Operand> arg = std::move(ops);
+  ops = std::move(caller);
+  if (args.size() >= 32) {
+    std::cerr << "Function " << fn.name << " is recursive.\n";
+    error = true;
+    ops.push_back(OPCODE(OP::CONST));
+    ops.push_back(VALUE(0));
+    return;
+  }
+  // inline the body, scanning it against the latest definitions
+  std::vector<Token> body = scanner.scan(fn.body, fn.arg);
+  if (scanner.hadError())
+    error = true;
+  names.insert(names.end(), scanner.getNames().begin(),
+               scanner.getNames().end());
+  std::vector<Token> callerTokens = std::move(tokens);
+  size_t callerIndex = tindex;
+  tokens = std::move(body);
+  tindex = 0;
+  args.push_back(std::move(arg));
+  expression();
+  args.pop_back();
+  tokens = std::move(callerTokens);
+  tindex = callerIndex;
+}
+
+/**
+ * @brief Descent case for the argument inside a user function body.
+ */
+void Parser::argument() {
+  std::vector<Operand>& arg = args.back();
+  ops.insert(ops.end(), arg.begin(), arg.end());
 }
 
 /**
@@ -184,7 +332,11 @@ void Parser::parsePrecedence(Precedence precedence) {
   tindex++;
   if (rule.prefix == NULL) {
     std::cerr << "Expected expression.\n";
-    exit(1);
+    // keep the stack balanced, the caller discards the program
+    error = true;
+    ops.push_back(OPCODE(OP::CONST));
+    ops.push_back(VALUE(0));
+    return;
   }
 
   (this->*rule.prefix)();
@@ -204,24 +356,53 @@ void Parser::parsePrecedence(Precedence precedence) {
  * @brief Parses a list of tokens, returning a list of opcodes.
  *
  * @param tokens std::vector<Token>& of tokens to parse.
+ * @param argument const std::vector<Operand>* the opcodes the argument of the
+ * scan (ARG tokens) compiles to, e.g. VAR to make t the variable, may be null.
  * @return std::vector<Operand> the parsed opcodes.
  */
-std::vector<Operand> Parser::parse(std::vector<Token>& tokens) {
+std::vector<Operand> Parser::parse(std::vector<Token>& tokens,
+                                   const std::vector<Operand>* argument) {
   this->tokens = tokens;
   ops = std::vector<Operand>();
+  args.clear();
+  if (argument != nullptr)
+    args.push_back(*argument);
+  names.clear();
+  error = false;
   tindex = 0;
   expression();
   return ops;
 }
 
+/**
+ * @brief Gets the user-definable names referenced by inlined function bodies
+ * during the last parse.
+ *
+ * @return const std::vector<std::string>& the referenced names.
+ */
+const std::vector<std::string>& Parser::getNames() const {
+  return names;
+}
+
+/**
+ * @brief Checks if the last parse found a syntax error. Errors do not end the
+ * program, so the parser can be embedded in other processes.
+ *
+ * @return bool true if the last parse failed.
+ */
+bool Parser::hadError() const {
+  return error;
+}
+
 /**
  * @brief Debug function to print the opcodes.
  *
  * @param ops std::vector<Operand>& the opcodes to print.
+ * @param stream std::ostream& the stream to print to.
  */
-void Parser::printOPs(std::vector<Operand>& ops) {
+void Parser::printOPs(std::vector<Operand>& ops, std::ostream& stream) {
   for (size_t i = 0; i < ops.size();) {
-    i = printOP(ops, i);
+    i = printOP(ops, i, stream);
   }
 }
 
@@ -230,57 +411,121 @@ void Parser::printOPs(std::vector<Operand>& ops) {
  *
  * @param ops std::vector<Operand>& the opcodes to print.
  * @param idx size_t the index of the opcode to print.
+ * @param stream std::ostream& the stream to print to.
  * @return int the index of the next opcode.
  */
-int Parser::printOP(std::vector<Operand>& ops, int idx) {
+int Parser::printOP(std::vector<Operand>& ops, int idx, std::ostream& stream) {
   OP op = ops[idx].opcode;
   switch (op) {
     case OP::VAR: {
-      std::cout << "VAR\n";
+      stream << "VAR\n";
+      return idx + 1;
+    }
+    case OP::VAR_Y: {
+      stream << "VAR_Y\n";
       return idx + 1;
     }
     case OP::NEG: {
-      std::cout << "NEG\n";
+      stream << "NEG\n";
       return idx + 1;
     }
     case OP::ADD: {
-      std::cout << "ADD\n";
+      stream << "ADD\n";
       return idx + 1;
     }
     case OP::SUB: {
-      std::cout << "SUB\n";
+      stream << "SUB\n";
       return idx + 1;
     }
     case OP::MUL: {
-      std::cout << "MUL\n";
+      stream << "MUL\n";
       return idx + 1;
     }
     case OP::DIV: {
-      std::cout << "DIV\n";
+      stream << "DIV\n";
       return idx + 1;
     }
     case OP::POW: {
-      std::cout << "POW\n";
+      stream << "POW\n";
       return idx + 1;
     }
     case OP::PLUS_OR_MINUS: {
-      std::cout << "PLUS_OR_MINUS\n";
+      stream << "PLUS_OR_MINUS\n";
       return idx + 1;
     }
     case OP::MAGIC: {
-      std::cout << "MAGIC\n";
+      stream << "MAGIC\n";
+      return idx + 1;
+    }
+    case OP::LESS: {
+      stream << "LESS\n";
+      return idx + 1;
+    }
+    case OP::LESS_EQUAL: {
+      stream << "LESS_EQUAL\n";
+      return idx + 1;
+    }
+    case OP::GREATER: {
+      stream << "GREATER\n";
       return idx + 1;
     }
+    case OP::GREATER_EQUAL: {
+      stream << "GREATER_EQUAL\n";
+      return idx + 1;
+    }
+    case OP::EQUAL: {
+      stream << "EQUAL\n";
+      return idx + 1;
+    }
+    case OP::NOT_EQUAL: {
+      stream << "NOT_EQUAL\n";
+      return idx + 1;
+    }
+    case OP::SELECT: {
+      stream << "SELECT\n";
+      return idx + 1;
+    }
+    case OP::POLY: {
+      int num = ops[idx + 1].index;
+      int den = ops[idx + 2].index;
+      stream << "POLY (";
+      for (int i = 0; i < num + den; i++) {
+        if (i == num)
+          stream << ") / (";
+        else if (i > 0)
+          stream << ", ";
+        stream << ops[idx + 3 + i].value;
+      }
+      stream << ")\n";
+      return idx + 3 + num + den;
+    }
     case OP::CONST: {
-      std::cout << "CONST (" << ops[idx + 1].value << ")\n";
+      stream << "CONST (" << ops[idx + 1].value << ")\n";
       return idx + 2;
     }
-    case OP::BUILTIN: {
-      std::cout << "BUILTIN (" << ops[idx + 1].fnptr << ")\n";
+    case OP::PARAM: {
+      if (env)
+        stream << "PARAM (" << env->get(ops[idx + 1].index).name << ")\n";
+      else
+        stream << "PARAM (" << ops[idx + 1].index << ")\n";
       return idx + 2;
     }
-    default:
-      std::cerr << "Unknown operation: " << +op << "\n";
-      exit(1);
+    case OP::CACHED: {
+      stream << "CACHED (" << ops[idx + 1].index << ")\n";
+      return idx + 2;
+    }
+    default: {
+      const Builtin* function = builtin(op);
+      if (function == nullptr) {
+        std::cerr << "Unknown operation: " << +op << "\n";
+        return idx + 1;
+      }
+      // builtins are listed by their name in capitals, e.g. SIN
+      for (const char* c = function->name; *c != '\0'; c++) {
+        stream << (char)std::toupper(*c);
+      }
+      stream << "\n";
+      return idx + 1;
+    }
   }
 }
\ No newline at end of file
@@ -0,0 +1,267 @@
+/**
+ * @file rasterizer.cpp
+ * @author Devin Arena
+ * @brief Implementation file for the offscreen rasterizer.
+ * @since 10/19/2026
+ **/
+
+#include "../include/rasterizer.hpp"
+#include "../include/parallel.hpp"
+#include "../include/termwriter.hpp"
+#include "../include/tgraph.hpp"
+#include "../include/vm.hpp"
+
+#include <stdio.h>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+static const unsigned char AXIS[3] = {190, 190, 190};
+
+/**
+ * @brief Gets the fractional part of a number.
+ *
+ * @param v double the number.
+ * @return double the fractional part, always positive.
+ */
+static inline double fpart(double v) {
+  return v - std::floor(v);
+}
+
+/**
+ * @brief Default constructor.
+ *
+ * @param env const Environment* parameter values, may be null.
+ * @param programs const std::vector<std::vector<Operand>>& the compiled
+ * equations to render.
+ * @param colours const std::vector<int>& the palette index of each equation.
+ * @param left double the world x of the left edge.
+ * @param right double the world x of the right edge.
+ * @param bottom double the world y of the bottom edge.
+ * @param top double the world y of the top edge.
+ */
+Rasterizer::Rasterizer(const Environment* env,
+                       const std::vector<std::vector<Operand>>& programs,
+                       const std::vector<int>& colours,
+                       double left,
+                       double right,
+                       double bottom,
+                       double top)
+    : env(env),
+      programs(programs),
+      colours(colours),
+      left(left),
+      right(right),
+      bottom(bottom),
+      top(top),
+      width(0),
+      height(0),
+      channels(1) {}
+
+/**
+ * @brief Evaluates every equation at the centre of every pixel column, split
+ * into batches across worker threads, and converts the results to pixel rows.
+ * Undefined values become NaN so no line is drawn through them.
+ */
+void Rasterizer::sample() {
+  curves.clear();
+  owners.clear();
+  std::vector<size_t> firstCurve(programs.size());
+  for (size_t e = 0; e < programs.size(); e++) {
+    firstCurve[e] = curves.size();
+    for (size_t r = 0; r < VM::results(programs[e]); r++) {
+      curves.emplace_back(width);
+      owners.push_back(colours[e]);
+    }
+  }
+
+  std::vector<VM> vms(workerCount(), VM(env));
+  std::vector<std::vector<double>> outs(workerCount());
+  size_t chunks = (width + VM_BATCH - 1) / VM_BATCH;
+  parallelFor(programs.size() * chunks, [&](unsigned worker, size_t job) {
+    size_t e = job / chunks;
+    int first = (job % chunks) * VM_BATCH;
+    int n = std::min(VM_BATCH, width - first);
+    double xs[VM_BATCH];
+    for (int k = 0; k < n; k++) {
+      xs[k] = left + (first + k + 0.5) * (right - left) / width;
+    }
+    std::vector<double>& out = outs[worker];
+    out.resize(VM_BATCH * VM::results(programs[e]));
+    size_t results = vms[worker].runBatch(programs[e], xs, n, out.data());
+    for (int k = 0; k < n; k++) {
+      for (size_t r = 0; r < results; r++) {
+        double y = out[k * results + r];
+        bool valid = std::isfinite(y) && y != INT_MIN && y != INT_MAX;
+        curves[firstCurve[e] + r][first + k] =
+            valid ? (top - y) / (top - bottom) * height - 0.5 : NAN;
+      }
+    }
+  });
+}
+
+/**
+ * @brief Blends a colour into a pixel if it lies inside the tile.
+ *
+ * @param tile const Tile& the tile being rendered.
+ * @param x int the pixel column.
+ * @param y int the pixel row.
+ * @param alpha double the coverage of the pixel, 0 to 1.
+ * @param color const unsigned char* the RGB colour.
+ */
+void Rasterizer::plot(const Tile& tile,
+                      int x,
+                      int y,
+                      double alpha,
+                      const unsigned char* color) {
+  if (x < tile.x || x >= tile.x + tile.w || y < tile.y || y >= tile.y + tile.h)
+    return;
+  unsigned char* p = tile.band + ((size_t)(y - tile.y) * width + x) * channels;
+  if (channels == 3) {
+    for (int c = 0; c < 3; c++) {
+      p[c] = std::lround(p[c] + (color[c] - p[c]) * alpha);
+    }
+  } else {
+    int luma = (299 * color[0] + 587 * color[1] + 114 * color[2]) / 1000;
+    p[0] = std::lround(p[0] + (luma - p[0]) * alpha);
+  }
+}
+
+/**
+ * @brief Draws an antialiased line (Xiaolin Wu's algorithm) between two points
+ * in pixel coordinates, only stepping over the part inside the tile.
+ *
+ * @param tile const Tile& the tile being rendered.
+ * @param x0 double the column of the first point.
+ * @param y0 double the row of the first point.
+ * @param x1 double the column of the second point.
+ * @param y1 double the row of the second point.
+ * @param color const unsigned char* the RGB colour.
+ */
+void Rasterizer::line(const Tile& tile,
+                      double x0,
+                      double y0,
+                      double x1,
+                      double y1,
+                      const unsigned char* color) {
+  bool steep = std::fabs(y1 - y0) > std::fabs(x1 - x0);
+  if (steep) {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1) {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  double gradient = x1 == x0 ? 1 : (y1 - y0) / (x1 - x0);
+  // plots along the major (stepped) and minor axes
+  auto put = [&](int major, double minor, double alpha) {
+    int m = std::floor(minor);
+    double f = minor - m;
+    if (steep) {
+      plot(tile, m, major, (1 - f) * alpha, color);
+      plot(tile, m + 1, major, f * alpha, color);
+    } else {
+      plot(tile, major, m, (1 - f) * alpha, color);
+      plot(tile, major, m + 1, f * alpha, color);
+    }
+  };
+
+  int start = std::round(x0);
+  put(start, y0 + gradient * (start - x0), 1 - fpart(x0 + 0.5));
+  int end = std::round(x1);
+  put(end, y1 + gradient * (end - x1), fpart(x1 + 0.5));
+
+  // clip the span between the endpoints to the tile
+  int lo = steep ? tile.y : tile.x;
+  int hi = steep ? tile.y + tile.h : tile.x + tile.w;
+  int from = std::max(start + 1, lo);
+  int to = std::min(end - 1, hi - 1);
+  double minor = y0 + gradient * (from - x0);
+  for (int major = from; major <= to; major++) {
+    put(major, minor, 1);
+    minor += gradient;
+  }
+}
+
+/**
+ * @brief Renders one tile: background, axes, then every curve segment that
+ * crosses it.
+ *
+ * @param tile const Tile& the tile to render.
+ */
+void Rasterizer::renderTile(const Tile& tile) {
+  for (int row = 0; row < tile.h; row++) {
+    std::memset(tile.band + ((size_t)row * width + tile.x) * channels, 255,
+                (size_t)tile.w * channels);
+  }
+
+  int axisX = std::lround(-left / (right - left) * width - 0.5);
+  int axisY = std::lround(top / (top - bottom) * height - 0.5);
+  for (int row = tile.y; row < tile.y + tile.h; row++) {
+    plot(tile, axisX, row, 1, AXIS);
+  }
+  for (int col = tile.x; col < tile.x + tile.w; col++) {
+    plot(tile, col, axisY, 1, AXIS);
+  }
+
+  int from = std::max(0, tile.x - 1);
+  int to = std::min(width - 1, tile.x + tile.w);
+  for (size_t c = 0; c < curves.size(); c++) {
+    const std::vector<double>& ys = curves[c];
+    const PaletteEntry& entry = PALETTE[owners[c] % PALETTE_SIZE];
+    const unsigned char color[3] = {(unsigned char)entry.r,
+                                    (unsigned char)entry.g,
+                                    (unsigned char)entry.b};
+    for (int p = from; p < to; p++) {
+      double y0 = ys[p];
+      double y1 = ys[p + 1];
+      // skip undefined values and jumps across the whole image (asymptotes)
+      if (std::isnan(y0) || std::isnan(y1) || std::fabs(y1 - y0) > height)
+        continue;
+      if (std::max(y0, y1) < tile.y - 1 || std::min(y0, y1) > tile.y + tile.h)
+        continue;
+      line(tile, p, y0, p + 1, y1, color);
+    }
+  }
+}
+
+/**
+ * @brief Renders the equations to a binary PGM (grayscale) or PPM (colour)
+ * image. The image is rendered one band of tiles at a time, the tiles of a
+ * band in parallel, and each band is written before the next one starts, so
+ * memory only grows with the width of the image.
+ *
+ * @param filename const std::string& the image file to write.
+ * @param width int the width of the image in pixels.
+ * @param height int the height of the image in pixels.
+ * @param color bool true to write a colour PPM, false for a grayscale PGM.
+ * @return bool true if the image was written.
+ */
+bool Rasterizer::render(const std::string& filename,
+                        int width,
+                        int height,
+                        bool color) {
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  this->width = width;
+  this->height = height;
+  channels = color ? 3 : 1;
+  fprintf(file, "%s\n%d %d\n255\n", color ? "P6" : "P5", width, height);
+
+  sample();
+  std::vector<unsigned char> band((size_t)width * RASTER_TILE * channels);
+  size_t tiles = (width + RASTER_TILE - 1) / RASTER_TILE;
+  for (int y = 0; y < height; y += RASTER_TILE) {
+    int h = std::min(RASTER_TILE, height - y);
+    parallelFor(tiles, [&](unsigned worker, size_t t) {
+      int x = t * RASTER_TILE;
+      renderTile(Tile{band.data(), x, y, std::min(RASTER_TILE, width - x), h});
+    });
+    fwrite(band.data(), 1, (size_t)width * h * channels, file);
+  }
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
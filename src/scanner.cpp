@@ -8,23 +8,30 @@
 
 #include "../include/scanner.hpp"
 #include "../include/builtins.hpp"
-#include "../include/tgraph.hpp"
+#include "../include/opcodes.hpp"
 
 #include <iostream>
 
 /**
  * @brief Default constructor.
+ *
+ * @param env const Environment* user definitions to resolve names against, may
+ * be null.
  */
-Scanner::Scanner() {}
+Scanner::Scanner(const Environment* env) : env(env), error(false) {}
 
 /**
  * @brief Scans an equation for different token types.
  *
  * @param equation the string to scan.
+ * @param arg the argument name when scanning a function body, or empty.
  * @return std::vector<Token> the tokens found in the string.
  */
-std::vector<Token> Scanner::scan(std::string& equation) {
+std::vector<Token> Scanner::scan(const std::string& equation,
+                                 const std::string& arg) {
   std::vector<Token> tokens;
+  names.clear();
+  error = false;
   for (size_t i = 0; i < equation.length(); i++) {
     if (equation[i] == ' ')
       continue;
@@ -60,15 +67,52 @@ std::vector<Token> Scanner::scan(std::string& equation) {
         tokens.push_back(TOKEN(TType::MAGIC));
         continue;
       }
+      case '<':
+      case '>': {
+        bool equal = i + 1 < equation.length() && equation[i + 1] == '=';
+        if (equation[i] == '<')
+          tokens.push_back(TOKEN(equal ? TType::LESS_EQUAL : TType::LESS));
+        else
+          tokens.push_back(
+              TOKEN(equal ? TType::GREATER_EQUAL : TType::GREATER));
+        i += equal;
+        continue;
+      }
+      case '=':
+      case '!': {
+        if (i + 1 < equation.length() && equation[i + 1] == '=') {
+          tokens.push_back(
+              TOKEN(equation[i] == '=' ? TType::EQUAL : TType::NOT_EQUAL));
+          i++;
+          continue;
+        }
+        break;
+      }
+      case '?': {
+        tokens.push_back(TOKEN(TType::QUESTION));
+        continue;
+      }
+      case ':': {
+        tokens.push_back(TOKEN(TType::COLON));
+        continue;
+      }
+      case ',': {
+        tokens.push_back(TOKEN(TType::COMMA));
+        continue;
+      }
       case 'x': {
         // ensure this is actually x and not part of a function or constant
-        if (i + 1 < equation.length()) {
-          if (!isalnum(equation[i + 1]))
-            tokens.push_back(TOKEN(TType::VAR));
+        if (i + 1 < equation.length() && isalnum(equation[i + 1]))
           continue;
-        } else
-          tokens.push_back(TOKEN(TType::VAR));
-        break;
+        tokens.push_back(TOKEN(TType::VAR));
+        continue;
+      }
+      case 'y': {
+        // names starting with y are scanned as words below
+        if (i + 1 < equation.length() && isalnum(equation[i + 1]))
+          break;
+        tokens.push_back(TOKEN(TType::VAR_Y));
+        continue;
       }
       case '(': {
         tokens.push_back(TOKEN(TType::O_PAREN));
@@ -108,6 +152,7 @@ std::vector<Token> Scanner::scan(std::string& equation) {
     if (p == i) {
       // if p = i, we didn't parse anything
       std::cerr << "Invalid token: " << equation[i] << "\n";
+      error = true;
     } else if (num) {
       // generate number tokens
       std::string num = equation.substr(i, p - i);
@@ -117,20 +162,51 @@ std::vector<Token> Scanner::scan(std::string& equation) {
     } else {
       // generate function tokens
       std::string name = equation.substr(i, p - i);
-      BuiltinFunc fn = resolveFunction(name);
-      if (fn != nullptr) {
+      const Builtin* function = resolveFunction(name);
+      int symbol = env ? env->resolve(name) : -1;
+      if (function != nullptr) {
         tokens.push_back(TOKEN(TType::FUNC));
-        tokens.push_back(FNPTR_TOKEN(fn));
+        tokens.push_back(INDEX_TOKEN(+function->opcode));
+      } else if (name == arg) {
+        tokens.push_back(TOKEN(TType::ARG));
       } else {
-        double constant = resolveConstant(name);
-        if (constant == 0) {
-          std::cerr << "Not a defined function or constant!\n";
+        // remember the name so definitions made later can find this equation
+        names.push_back(name);
+        if (symbol != -1) {
+          bool param = env->get(symbol).kind == SymbolKind::PARAM;
+          tokens.push_back(TOKEN(param ? TType::PARAM : TType::CALL));
+          tokens.push_back(INDEX_TOKEN(symbol));
+        } else {
+          double constant = resolveConstant(name);
+          if (constant == 0) {
+            std::cerr << "Not a defined function or constant!\n";
+          }
+          tokens.push_back(TOKEN(TType::CONST));
+          tokens.push_back(VALUE_TOKEN(constant));
         }
-        tokens.push_back(TOKEN(TType::CONST));
-        tokens.push_back(VALUE_TOKEN(constant));
       }
       i = p - 1;
     }
   }
   return tokens;
-}
\ No newline at end of file
+}
+
+// Getters and Setters
+
+/**
+ * @brief Gets the user-definable names referenced by the last scan.
+ *
+ * @return const std::vector<std::string>& the referenced names.
+ */
+const std::vector<std::string>& Scanner::getNames() const {
+  return names;
+}
+
+/**
+ * @brief Checks if the last scan found an invalid token.
+ *
+ * @return bool true if the last scan failed.
+ */
+bool Scanner::hadError() const {
+  return error;
+}
@@ -0,0 +1,350 @@
+/**
+ * @file server.cpp
+ * @author Devin Arena
+ * @brief Implementation file for the local render server.
+ *
+ * Protocol: each request is one line, each response is a header line
+ * "ok <bytes>" or "error <bytes>" followed by that many bytes of payload.
+ *   render <width> <height> <xstep> <ystep> [at <x> <y>] <expr>[;<expr>...]
+ *     -> height rows of width characters, each ending in a newline, of the
+ *        view centred on (x, y), (0, 0) by default
+ *   eval <x0> <x1> <n> <expr>
+ *     -> n lines of x,y[,y2...]
+ *   quit
+ *     -> closes the connection
+ * @since 10/19/2026
+ **/
+
+#include "../include/server.hpp"
+#include "../include/parallel.hpp"
+#include "../include/tgraph.hpp"
+
+#ifdef TG_LINUX
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// longest request line accepted
+#define MAX_REQUEST (1 << 20)
+// largest render (characters) or evaluation (samples) served
+#define MAX_CELLS (1 << 24)
+
+static std::string socketPath;
+
+/**
+ * @brief Removes the socket file when the server is stopped.
+ *
+ * @param sig int the signal received.
+ */
+static void stopServer(int sig) {
+  unlink(socketPath.c_str());
+  _exit(0);
+}
+
+/**
+ * @brief Gets a compiled expression, compiling it on first use. Surrounding
+ * whitespace is ignored, so it does not compile the same expression twice.
+ *
+ * @param text const std::string& the expression.
+ * @return std::shared_ptr<tg_program> the program, null if it is invalid.
+ */
+std::shared_ptr<tg_program> ProgramCache::get(const std::string& text) {
+  size_t first = text.find_first_not_of(" \t\r");
+  std::string expression =
+      first == std::string::npos
+          ? ""
+          : text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto found = programs.find(expression);
+    if (found != programs.end())
+      return found->second;
+  }
+  // compile outside the lock, another worker may race us to the insert
+  std::shared_ptr<tg_program> program(tg_compile(expression.c_str()),
+                                      &tg_free);
+  if (program == nullptr)
+    return program;
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  if (programs.size() >= CACHE_LIMIT)
+    programs.clear();
+  return programs.emplace(expression, program).first->second;
+}
+
+/**
+ * @brief Gets the number of cached programs.
+ *
+ * @return size_t the number of cached programs.
+ */
+size_t ProgramCache::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex);
+  return programs.size();
+}
+
+/**
+ * @brief Default constructor.
+ *
+ * @param path const std::string& the unix socket to listen on.
+ */
+Server::Server(const std::string& path) : path(path) {}
+
+/**
+ * @brief Listens on the socket, handing accepted connections to a pool of
+ * workers. Runs until the process is interrupted.
+ *
+ * @return int exit code for the program.
+ */
+int Server::run() {
+#ifdef TG_LINUX
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (listener < 0 || path.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "Invalid socket path: " << path << "\n";
+    return 1;
+  }
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(path.c_str());
+  if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+      listen(listener, 128) != 0) {
+    std::cerr << "Could not listen on " << path << ": " << strerror(errno)
+              << "\n";
+    return 1;
+  }
+  socketPath = path;
+  signal(SIGINT, stopServer);
+  signal(SIGTERM, stopServer);
+  signal(SIGPIPE, SIG_IGN);
+
+  unsigned workers = workerCount();
+  for (unsigned i = 0; i < workers; i++) {
+    std::thread(&Server::worker, this).detach();
+  }
+  std::cout << "Serving on " << path << " with " << workers << " workers.\n";
+  while (true) {
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0)
+      continue;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      connections.push(fd);
+    }
+    ready.notify_one();
+  }
+#else
+  std::cerr << "--serve is not supported on this platform.\n";
+  return 1;
+#endif
+}
+
+/**
+ * @brief Worker loop, serves one connection at a time until it closes.
+ */
+void Server::worker() {
+  while (true) {
+    int fd;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      ready.wait(lock, [this] { return !connections.empty(); });
+      fd = connections.front();
+      connections.pop();
+    }
+    serve(fd);
+  }
+}
+
+/**
+ * @brief Reads request lines from a connection and writes the responses.
+ *
+ * @param fd int the connection.
+ */
+void Server::serve(int fd) {
+#ifdef TG_LINUX
+  std::string pending;
+  std::string response;
+  char buffer[1 << 16];
+  bool open = true;
+  while (open) {
+    ssize_t got = read(fd, buffer, sizeof(buffer));
+    if (got <= 0)
+      break;
+    pending.append(buffer, got);
+    size_t start = 0;
+    size_t end;
+    while (open && (end = pending.find('\n', start)) != std::string::npos) {
+      std::string request = pending.substr(start, end - start);
+      start = end + 1;
+      if (!request.empty() && request.back() == '\r')
+        request.pop_back();
+      open = handle(request, response);
+      const char* p = response.data();
+      size_t left = response.size();
+      while (left > 0) {
+        ssize_t sent = write(fd, p, left);
+        if (sent <= 0) {
+          open = false;
+          break;
+        }
+        p += sent;
+        left -= sent;
+      }
+    }
+    pending.erase(0, start);
+    if (pending.size() > MAX_REQUEST)
+      break;
+  }
+  close(fd);
+#endif
+}
+
+/**
+ * @brief Answers a single request.
+ *
+ * @param request const std::string& the request line.
+ * @param response std::string& receives the response, header and payload.
+ * @return bool false if the connection should be closed.
+ */
+bool Server::handle(const std::string& request, std::string& response) {
+  std::istringstream args(request);
+  std::string command;
+  args >> command;
+  std::string payload;
+  bool ok;
+  if (command == "render") {
+    ok = render(args, payload);
+  } else if (command == "eval") {
+    ok = evaluate(args, payload);
+  } else if (command == "quit") {
+    response.clear();
+    return false;
+  } else {
+    ok = false;
+    payload = "unknown command";
+  }
+  response = (ok ? "ok " : "error ") + std::to_string(payload.size()) + "\n";
+  response += payload;
+  return true;
+}
+
+/**
+ * @brief Handles render <width> <height> <xstep> <ystep> [at <x> <y>]
+ * <expr>[;<expr>...].
+ *
+ * @param args std::istringstream& the arguments of the request.
+ * @param payload std::string& receives the rendered rows or an error.
+ * @return bool true on success.
+ */
+bool Server::render(std::istringstream& args, std::string& payload) {
+  int width, height;
+  double xstep, ystep;
+  double originX = 0, originY = 0;
+  std::string list;
+  const char* usage =
+      "usage: render <width> <height> <xstep> <ystep> [at <x> <y>] <exprs>";
+  if (!(args >> width >> height >> xstep >> ystep) || width <= 0 ||
+      height <= 0 || (long)width * height > MAX_CELLS ||
+      !std::isfinite(xstep) || !std::isfinite(ystep) || xstep == 0 ||
+      ystep == 0) {
+    payload = usage;
+    return false;
+  }
+  std::getline(args, list);
+  // the view is centred on the origin unless the expressions follow "at x y"
+  std::istringstream view(list);
+  std::string word;
+  if (view >> word && word == "at") {
+    if (!(view >> originX >> originY) || !std::isfinite(originX) ||
+        !std::isfinite(originY)) {
+      payload = usage;
+      return false;
+    }
+    std::getline(view, list);
+  }
+
+  std::vector<std::shared_ptr<tg_program>> held;
+  std::vector<const tg_program*> programs;
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t end = std::min(list.find(';', start), list.size());
+    std::string expression = list.substr(start, end - start);
+    start = end + 1;
+    if (expression.find_first_not_of(' ') == std::string::npos)
+      continue;
+    std::shared_ptr<tg_program> program = cache.get(expression);
+    if (program == nullptr) {
+      payload = "invalid expression:" + expression;
+      return false;
+    }
+    held.push_back(program);
+    programs.push_back(program.get());
+  }
+
+  std::vector<char> cells((size_t)width * height);
+  if (tg_render_view(programs.data(), programs.size(), xstep, ystep, originX,
+                     originY, cells.data(), width, height) != 0) {
+    payload = usage;
+    return false;
+  }
+  payload.reserve((size_t)(width + 1) * height);
+  for (int j = 0; j < height; j++) {
+    payload.append(&cells[(size_t)j * width], width);
+    payload += '\n';
+  }
+  return true;
+}
+
+/**
+ * @brief Handles eval <x0> <x1> <n> <expr>.
+ *
+ * @param args std::istringstream& the arguments of the request.
+ * @param payload std::string& receives the samples or an error.
+ * @return bool true on success.
+ */
+bool Server::evaluate(std::istringstream& args, std::string& payload) {
+  double x0, x1;
+  long n;
+  std::string expression;
+  if (!(args >> x0 >> x1 >> n) || n <= 0 || n > MAX_CELLS) {
+    payload = "usage: eval <x0> <x1> <n> <expr>";
+    return false;
+  }
+  std::getline(args, expression);
+  std::shared_ptr<tg_program> program = cache.get(expression);
+  if (program == nullptr) {
+    payload = "invalid expression:" + expression;
+    return false;
+  }
+
+  size_t results = tg_results(program.get());
+  double step = n > 1 ? (x1 - x0) / (n - 1) : 0;
+  std::vector<double> xs(VM_BATCH);
+  std::vector<double> ys(VM_BATCH * results);
+  char number[32];
+  for (long first = 0; first < n; first += VM_BATCH) {
+    long count = std::min<long>(VM_BATCH, n - first);
+    for (long k = 0; k < count; k++) {
+      xs[k] = x0 + step * (first + k);
+    }
+    tg_eval(program.get(), xs.data(), 1, ys.data(), results, count);
+    for (long k = 0; k < count; k++) {
+      payload.append(number, std::to_chars(number, number + 32, xs[k]).ptr);
+      for (size_t r = 0; r < results; r++) {
+        payload += ',';
+        payload.append(number, std::to_chars(number, number + 32,
+                                             ys[k * results + r])
+                                   .ptr);
+      }
+      payload += '\n';
+    }
+  }
+  return true;
+}
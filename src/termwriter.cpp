@@ -0,0 +1,258 @@
+/**
+ * @file termwriter.cpp
+ * @author Devin Arena
+ * @brief Implementation file for the diff-based terminal writer.
+ * @since 10/19/2026
+ **/
+
+#include "../include/termwriter.hpp"
+#include "../include/tgraph.hpp"
+#include "../include/tracer.hpp"
+
+#ifdef TG_WINDOWS
+#include <windows.h>
+#endif
+#include <stdio.h>
+
+// unchanged cells shorter than this between two changes are resent instead of
+// emitting another cursor movement
+#define MAX_GAP 8
+
+const PaletteEntry PALETTE[PALETTE_SIZE] = {
+    {91, 203, 255, 95, 95},   {92, 83, 95, 215, 95},
+    {93, 227, 255, 215, 95},  {94, 75, 95, 175, 255},
+    {95, 213, 255, 135, 255}, {96, 87, 95, 255, 255},
+    {33, 208, 255, 135, 0},   {35, 141, 175, 135, 255},
+    {36, 37, 0, 175, 175},    {32, 154, 175, 255, 0},
+    {31, 211, 255, 135, 175}, {34, 117, 135, 215, 255}};
+
+/**
+ * @brief Default constructor. On Windows, enables escape sequence processing
+ * on the console.
+ */
+TermWriter::TermWriter() : current(0) {
+#ifdef TG_WINDOWS
+  HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+  DWORD mode = 0;
+  if (GetConsoleMode(out, &mode))
+    SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+  SetConsoleOutputCP(CP_UTF8);
+#endif
+}
+
+/**
+ * @brief Chooses how cell colours are sent, building the escape sequence of
+ * each colour once. The next frame is written in full.
+ *
+ * @param mode ColourMode how colours are sent, OFF for plain text.
+ */
+void TermWriter::setColours(ColourMode mode) {
+  escapes.clear();
+  invalidate();
+  if (mode == ColourMode::OFF)
+    return;
+  escapes.push_back("\x1b[39m");
+  char seq[32];
+  for (const PaletteEntry& entry : PALETTE) {
+    if (mode == ColourMode::ANSI16)
+      snprintf(seq, sizeof(seq), "\x1b[%dm", entry.ansi);
+    else if (mode == ColourMode::ANSI256)
+      snprintf(seq, sizeof(seq), "\x1b[38;5;%dm", entry.xterm);
+    else
+      snprintf(seq, sizeof(seq), "\x1b[38;2;%d;%d;%dm", entry.r, entry.g,
+               entry.b);
+    escapes.push_back(seq);
+  }
+}
+
+/**
+ * @brief Checks if cell colours are sent.
+ *
+ * @return bool true if colour is on.
+ */
+bool TermWriter::coloured() const {
+  return !escapes.empty();
+}
+
+/**
+ * @brief Appends a cursor movement to the output buffer.
+ *
+ * @param row int the 0 based row to move to.
+ * @param col int the 0 based column to move to.
+ */
+void TermWriter::moveTo(int row, int col) {
+  char seq[32];
+  int len = snprintf(seq, sizeof(seq), "\x1b[%d;%dH", row + 1, col + 1);
+  buffer.append(seq, len);
+}
+
+/**
+ * @brief Appends a run of cells as UTF-8, selecting a colour only when a
+ * visible glyph has a different colour than the last one sent. Spaces keep
+ * whatever colour is selected, so runs extend across the gaps between them.
+ *
+ * @param out std::string& the output to append to.
+ * @param row const std::u32string& the glyphs of the row.
+ * @param colours const ColourRow* the colours of the row, may be null.
+ * @param first size_t the first cell of the run.
+ * @param last size_t one past the last cell of the run.
+ */
+void TermWriter::appendCells(std::string& out,
+                             const std::u32string& row,
+                             const ColourRow* colours,
+                             size_t first,
+                             size_t last) {
+  bool colour = colours != nullptr && !escapes.empty();
+  for (size_t i = first; i < last; i++) {
+    if (colour && row[i] != U' ' && (*colours)[i] != current) {
+      current = (*colours)[i];
+      out += escapes[current];
+    }
+    appendUTF8(out, row[i]);
+  }
+}
+
+/**
+ * @brief Appends an escape returning to the default colour, if another colour
+ * is selected.
+ *
+ * @param out std::string& the output to append to.
+ */
+void TermWriter::resetColour(std::string& out) {
+  if (current != 0)
+    out += escapes[0];
+  current = 0;
+}
+
+/**
+ * @brief Presents a frame. The first frame (or a frame of a different size) is
+ * written in full, later frames only send the runs of cells that changed. A
+ * space is unchanged if it was a space, whatever its colour.
+ *
+ * @param frame const std::vector<std::u32string>& the rows of the frame.
+ * @param stream std::ostream& the stream to write to.
+ * @param colours const std::vector<ColourRow>* the colours of the cells, or
+ * null to draw in the default colour.
+ */
+void TermWriter::present(const std::vector<std::u32string>& frame,
+                         std::ostream& stream,
+                         const std::vector<ColourRow>* colours) {
+  buffer.clear();
+  bool resized = front.size() != frame.size() ||
+                 (!frame.empty() && front[0].size() != frame[0].size());
+  bool colour = colours != nullptr && !escapes.empty();
+  if (resized) {
+    // hide the cursor and clear the terminal
+    buffer += "\x1b[?25l\x1b[H\x1b[2J";
+    for (size_t j = 0; j < frame.size(); j++) {
+      moveTo(j, 0);
+      appendCells(buffer, frame[j], colour ? &(*colours)[j] : nullptr, 0,
+                  frame[j].size());
+    }
+    front = frame;
+    if (colour)
+      frontColours = *colours;
+    else
+      frontColours.assign(frame.size(),
+                          ColourRow(frame.empty() ? 0 : frame[0].size(), 0));
+  } else {
+    for (size_t j = 0; j < frame.size(); j++) {
+      const std::u32string& next = frame[j];
+      std::u32string& prev = front[j];
+      ColourRow& prevColours = frontColours[j];
+      const ColourRow* nextColours = colour ? &(*colours)[j] : nullptr;
+      auto changed = [&](size_t i) {
+        if (next[i] != prev[i])
+          return true;
+        uint8_t c = nextColours != nullptr ? (*nextColours)[i] : 0;
+        return next[i] != U' ' && c != prevColours[i];
+      };
+      size_t i = 0;
+      while (i < next.size()) {
+        if (!changed(i)) {
+          i++;
+          continue;
+        }
+        size_t last = i;
+        for (size_t end = i + 1; end < next.size() && end - last <= MAX_GAP;
+             end++) {
+          if (changed(end))
+            last = end;
+        }
+        moveTo(j, i);
+        appendCells(buffer, next, nextColours, i, last + 1);
+        i = last + 1;
+      }
+      prev = next;
+      if (nextColours != nullptr)
+        prevColours = *nextColours;
+      else
+        prevColours.assign(next.size(), 0);
+    }
+  }
+  resetColour(buffer);
+  {
+    TG_TRACE("flush");
+    stream.write(buffer.data(), buffer.size());
+    stream.flush();
+  }
+  Tracer::instance().nextFrame();
+}
+
+/**
+ * @brief Encodes a whole frame as lines of text, coloured the same way as a
+ * presented frame, e.g. for drawing below the prompt.
+ *
+ * @param frame const std::vector<std::u32string>& the rows of the frame.
+ * @param colours const std::vector<ColourRow>* the colours of the cells, or
+ * null for plain text.
+ * @param out std::string& receives the text.
+ */
+void TermWriter::encode(const std::vector<std::u32string>& frame,
+                        const std::vector<ColourRow>* colours,
+                        std::string& out) {
+  for (size_t j = 0; j < frame.size(); j++) {
+    appendCells(out, frame[j], colours != nullptr ? &(*colours)[j] : nullptr,
+                0, frame[j].size());
+    out += '\n';
+  }
+  resetColour(out);
+}
+
+/**
+ * @brief Leaves frame mode, moving the cursor below the frame and showing it.
+ *
+ * @param stream std::ostream& the stream to write to.
+ */
+void TermWriter::finish(std::ostream& stream) {
+  buffer.clear();
+  moveTo(front.empty() ? 0 : front.size() - 1, 0);
+  buffer += "\x1b[?25h\n";
+  stream.write(buffer.data(), buffer.size());
+  stream.flush();
+}
+
+/**
+ * @brief Forgets the frame on the terminal, e.g. after something else drew
+ * over it, so the next frame is written in full.
+ */
+void TermWriter::invalidate() {
+  front.clear();
+  frontColours.clear();
+}
+
+/**
+ * @brief Gets the memory held by the shown frame and the output buffer.
+ *
+ * @return size_t the size in bytes.
+ */
+size_t TermWriter::footprint() const {
+  size_t bytes = front.capacity() * sizeof(std::u32string) + buffer.capacity();
+  for (const std::u32string& row : front) {
+    bytes += row.capacity() * sizeof(char32_t);
+  }
+  for (const ColourRow& row : frontColours) {
+    bytes += row.capacity();
+  }
+  return bytes;
+}
@@ -7,161 +7,2955 @@
  **/
 
 #include "../include/tgraph.hpp"
+#include "../include/alloctracker.hpp"
+#include "../include/exporter.hpp"
+#include "../include/parallel.hpp"
+#include "../include/plot.hpp"
+#include "../include/rasterizer.hpp"
+#include "../include/tracer.hpp"
 
 #include <stdlib.h>
+#ifdef TG_WINDOWS
 #include <windows.h>
+#endif
+#ifdef TG_LINUX
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
 #include <vector>
 
-TGraph::TGraph() {
-  setupWindow();
+// the prompt shown by the cli
+#define PROMPT "Equation or command > (f(x) = ) "
+
+/**
+ * @brief Gets the colour a curve (or dataset) is drawn in.
+ *
+ * @param index int the index of the equation, datasets follow the equations.
+ * @return uint8_t the cell colour, cycling through the palette.
+ */
+static uint8_t curveColour(int index) {
+  return 1 + index % PALETTE_SIZE;
+}
+
+// set by SIGWINCH, checked by the render thread
+static std::atomic<bool> windowChanged{false};
+
+#ifdef TG_LINUX
+/**
+ * @brief Flags that the terminal was resized.
+ *
+ * @param sig int the signal received.
+ */
+static void onWindowChange(int sig) {
+  windowChanged = true;
+}
+#endif
+
+/**
+ * @brief Default constructor, sets up a blank graph.
+ *
+ * @param headless bool true to replay a session without a terminal.
+ */
+TGraph::TGraph(bool headless)
+    : paneVMs(workerCount(), VM(&env)),
+      headless(headless),
+      parser(&env),
+      scanner(&env),
+      vm(&env, &cache) {
+  setupWindow();
+}
+
+/**
+ * @brief Strips leading and trailing spaces from a string.
+ *
+ * @param text const std::string& the string to trim.
+ * @return std::string the trimmed string.
+ */
+static std::string trim(const std::string& text) {
+  size_t start = text.find_first_not_of(' ');
+  if (start == std::string::npos)
+    return "";
+  size_t end = text.find_last_not_of(' ');
+  return text.substr(start, end - start + 1);
+}
+
+/**
+ * @brief Checks if a name can be used for a user definition.
+ *
+ * @param name const std::string& the name to check.
+ * @return bool true if the name is alphanumeric, starts with a letter and
+ * does not clash with x, y or a builtin function.
+ */
+static bool isDefinable(const std::string& name) {
+  if (name.empty() || !isalpha(name[0]) || name[0] == 'x' || name == "y")
+    return false;
+  for (char c : name) {
+    if (!isalnum(c))
+      return false;
+  }
+  return resolveFunction(name) == nullptr;
+}
+
+/**
+ * @brief Checks if a word starts a command, input starting with anything else
+ * is an equation.
+ *
+ * @param word const std::string& the first word of the input.
+ * @return bool true if it is a command.
+ */
+static bool isCommand(const std::string& word) {
+  static const char* const COMMANDS[] = {
+      "help",   "let",   "animate", "export", "profile", "mode",  "colour",
+      "color",  "implicit", "heat", "param",  "polar",   "split", "pane",
+      "memory", "render", "load",   "left",   "right",   "up",    "down",
+      "center", "graph", "clear",   "exit",   "xstep",   "ystep", "-",
+      "+",      "save",  "watch"};
+  for (const char* command : COMMANDS) {
+    if (word == command)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Checks if a view shows an equation.
+ *
+ * @param shown const std::vector<char>& whether the view shows each equation.
+ * @param equation size_t the index of the equation.
+ * @return bool true if it is shown, equations added since the view chose its
+ * equations are.
+ */
+static bool visible(const std::vector<char>& shown, size_t equation) {
+  return equation >= shown.size() || shown[equation];
+}
+
+/**
+ * @brief Checks if the columns of dots of one view land on columns of
+ * another, i.e. its column spacing is a whole multiple of the other's and
+ * the columns line up, so its samples can be copied instead of evaluated.
+ *
+ * @param from const View& the view whose samples would be reused.
+ * @param to const View& the view to compute.
+ * @param dotsX int the columns of dots across a cell.
+ * @param scale int& receives the columns of from per column of to.
+ * @param offset long& receives the column of from the first column of to
+ * lands on, may be negative.
+ * @return bool true if the columns line up and at least one column overlaps.
+ */
+static bool aligned(const View& from,
+                    const View& to,
+                    int dotsX,
+                    int& scale,
+                    long& offset) {
+  double ratio = to.stepX / from.stepX;
+  scale = std::lround(ratio);
+  if (scale < 1 || std::fabs(ratio - scale) > 1e-9 * ratio)
+    return false;
+  double shift =
+      (plotDotX(0, to.screenWidth, dotsX, to.stepX, to.originX) -
+       plotDotX(0, from.screenWidth, dotsX, from.stepX, from.originX)) /
+      (from.stepX / dotsX);
+  offset = std::llround(shift);
+  if (std::fabs(shift - offset) > 1e-6)
+    return false;
+  long columns = (long)from.screenWidth * dotsX;
+  return offset < columns &&
+         offset + (long)scale * (to.screenWidth * dotsX - 1) >= 0;
+}
+
+/**
+ * @brief Reads the size of the terminal and lays the panes out over it. A
+ * headless replay keeps the size set by the session.
+ */
+void TGraph::readWindowSize() {
+  if (headless) {
+    layout();
+    return;
+  }
+// get the window size based on platform
+// windows
+#ifdef TG_WINDOWS
+  CONSOLE_SCREEN_BUFFER_INFO csbi;
+  GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi);
+  terminalWidth = csbi.srWindow.Right - csbi.srWindow.Left + 1;
+  terminalHeight = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
+#endif
+// macOS and Linux
+#ifdef TG_LINUX
+  struct winsize w;
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0 && w.ws_col > 0) {
+    terminalWidth = w.ws_col;
+    terminalHeight = w.ws_row;
+  } else {
+    // not a terminal (e.g. output is piped)
+    terminalWidth = 80;
+    terminalHeight = 24;
+  }
+#endif
+  layout();
+}
+
+/**
+ * @brief Sets the size of the terminal, as a headless replay does, and lays
+ * the panes out over it.
+ *
+ * @param width int the columns of the terminal.
+ * @param height int the rows of the terminal.
+ */
+void TGraph::resize(int width, int height) {
+  terminalWidth = width;
+  terminalHeight = height;
+  layout();
+}
+
+/**
+ * @brief Sets the cells each pane covers from its share of the terminal. A
+ * pane right of or below another leaves a cell for the separator.
+ */
+void TGraph::layout() {
+  for (size_t p = 0; p < panes.size(); p++) {
+    Pane& pane = panes[p];
+    int right = std::lround(pane.x1 * terminalWidth);
+    int bottom = std::lround(pane.y1 * terminalHeight);
+    pane.left = std::lround(pane.x0 * terminalWidth);
+    pane.top = std::lround(pane.y0 * terminalHeight);
+    pane.left = std::min(pane.left + (pane.left > 0), terminalWidth - 1);
+    pane.top = std::min(pane.top + (pane.top > 0), terminalHeight - 1);
+    bool loaded = (int)p == focused;
+    (loaded ? screenWidth : pane.view.screenWidth) =
+        std::max(1, right - pane.left);
+    (loaded ? screenHeight : pane.view.screenHeight) =
+        std::max(1, bottom - pane.top);
+  }
+}
+
+/**
+ * @brief Exchanges the view in the members of TGraph with a stored one.
+ *
+ * @param view View& the stored view, receives the loaded one.
+ */
+void TGraph::swapView(View& view) {
+  std::swap(screenWidth, view.screenWidth);
+  std::swap(screenHeight, view.screenHeight);
+  std::swap(stepX, view.stepX);
+  std::swap(stepY, view.stepY);
+  std::swap(originX, view.originX);
+  std::swap(originY, view.originY);
+  samples.swap(view.samples);
+  strides.swap(view.strides);
+  shown.swap(view.shown);
+}
+
+/**
+ * @brief Loads the view of a pane into the members, storing the view loaded
+ * before in its own pane.
+ *
+ * @param pane int the index of the pane to load.
+ */
+void TGraph::focus(int pane) {
+  if (pane == focused)
+    return;
+  swapView(panes[focused].view);
+  focused = pane;
+  swapView(panes[pane].view);
+}
+
+/**
+ * @brief Sets up the window. Grabs the window size, initializes the screen, and
+ * draws a blank graph.
+ */
+void TGraph::setupWindow() {
+  panes.assign(1, Pane());
+  active = 0;
+  focused = 0;
+  readWindowSize();
+  screen = std::vector(screenHeight, std::vector(screenWidth, ' '));
+
+  stepX = 1.0;
+  stepY = 1.0;
+  originX = 0.0;
+  originY = 0.0;
+  ops.clear();
+  equations.clear();
+  deps.clear();
+  samples.clear();
+  strides.clear();
+  shown.clear();
+  datasets.clear();
+  dataLows.clear();
+  dataHighs.clear();
+  fields.clear();
+  curves.clear();
+  watcher.close();
+  watched.clear();
+
+  rerender();
+}
+
+/**
+ * @brief Helper for writing text to the screen 2d array.
+ *
+ * @param text std::string_view The text to write.
+ * @param x int The x coordinate to write the text to.
+ * @param y int The y coordinate to write the text to.
+ * @param colour uint8_t the colour of the text, the default colour if 0.
+ */
+void TGraph::writeToScreen(std::string_view text,
+                           int x,
+                           int y,
+                           uint8_t colour) {
+  if (y >= screenHeight)
+    return;
+  for (size_t i = 0; i < text.length() && x + (int)i < screenWidth; i++) {
+    screen[y][x + i] = text[i];
+    colours[y * screenWidth + x + i] = colour;
+    // the spaces in text are not shaded
+    shades[y * screenWidth + x + i] = 0;
+  }
+}
+
+/**
+ * @brief CLI interface. Lines are read on this thread and queued for a
+ * separate render thread, so the prompt never waits on a render, and a line
+ * typed while a render is running cancels it when it has been superseded.
+ */
+void TGraph::cli() {
+#ifdef TG_LINUX
+  struct sigaction action {};
+  action.sa_handler = onWindowChange;
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGWINCH, &action, nullptr);
+#endif
+  async = true;
+  std::thread renderer(&TGraph::renderLoop, this);
+  std::string command{""};
+  do {
+    if (!std::getline(std::cin, command))
+      command.clear();
+    // an empty line stops the render thread once it gets to it
+    pending++;
+    while (!commands.push(command)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+      std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+  } while (command.length() > 0);
+  renderer.join();
+  async = false;
+}
+
+/**
+ * @brief Runs the queued commands, and reloads the watched file when it is
+ * written. When the queue runs dry, finishes any render that was abandoned
+ * for a newer command and shows the prompt, then sleeps until the next
+ * command or a terminal resize.
+ */
+void TGraph::renderLoop() {
+  Tracer::instance().nameThread("render");
+  std::cout << PROMPT << std::flush;
+  bool prompt = false;
+  std::string command;
+  while (true) {
+    if (commands.pop(command)) {
+      pending--;
+      if (command.empty())
+        break;
+      parseInput(command);
+      prompt = true;
+    } else if (windowChanged.exchange(false)) {
+      readWindowSize();
+      writer.invalidate();
+      rerender();
+      prompt = true;
+    } else if (watcher.changed()) {
+      reloadWatched();
+      prompt = true;
+    } else if (dirty) {
+      rerender();
+    } else {
+      if (prompt)
+        std::cout << PROMPT << std::flush;
+      prompt = false;
+      // SIGWINCH cannot notify, so the wait also wakes up to check for it
+      std::unique_lock<std::mutex> lock(wakeMutex);
+      wake.wait_for(lock, std::chrono::milliseconds(100),
+                    [this] { return pending.load() > 0; });
+    }
+  }
+  // nothing can supersede the last render any more
+  settle();
+}
+
+/**
+ * @brief Checks if the render in progress has been superseded by a queued
+ * command or a terminal resize.
+ *
+ * @return bool true if the render should be abandoned.
+ */
+bool TGraph::cancelled() const {
+  return async && (pending.load(std::memory_order_relaxed) > 0 ||
+                   windowChanged.load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief Finishes an abandoned render without allowing it to be cancelled,
+ * for commands that need the graph up to date (e.g. save).
+ */
+void TGraph::settle() {
+  if (!dirty)
+    return;
+  bool wasAsync = async;
+  async = false;
+  rerender();
+  async = wasAsync;
+}
+
+/**
+ * @brief Gets the number of columns of dots, the columns equations are
+ * evaluated at.
+ *
+ * @return int the screen width times the dots across a cell.
+ */
+int TGraph::sampleColumns() const {
+  return screenWidth * plotDotsX(mode);
+}
+
+/**
+ * @brief Gets the x value of a column of dots.
+ *
+ * @param column int the column of dots.
+ * @return double the x value.
+ */
+double TGraph::sampleX(int column) const {
+  return plotDotX(column, screenWidth, plotDotsX(mode), stepX, originX);
+}
+
+/**
+ * @brief Switches how curves are drawn and re-renders, since the number of
+ * columns evaluated depends on the mode.
+ *
+ * @param name const std::string& ascii, halfblock or braille.
+ */
+void TGraph::setMode(const std::string& name) {
+  if (name.compare("ascii") == 0) {
+    mode = PlotMode::ASCII;
+  } else if (name.compare("halfblock") == 0) {
+    mode = PlotMode::HALFBLOCK;
+  } else if (name.compare("braille") == 0) {
+    mode = PlotMode::BRAILLE;
+  } else {
+    std::cout << "Invalid command syntax.\n";
+    return;
+  }
+  rerender();
+}
+
+/**
+ * @brief Chooses how curves are coloured on the terminal and redraws. Saved
+ * files are never coloured.
+ *
+ * @param name const std::string& off, 16, 256 or truecolor.
+ */
+void TGraph::setColours(const std::string& name) {
+  if (name.compare("off") == 0) {
+    writer.setColours(ColourMode::OFF);
+  } else if (name.compare("16") == 0) {
+    writer.setColours(ColourMode::ANSI16);
+  } else if (name.compare("256") == 0) {
+    writer.setColours(ColourMode::ANSI256);
+  } else if (name.compare("truecolor") == 0) {
+    writer.setColours(ColourMode::TRUECOLOR);
+  } else {
+    std::cout << "Invalid command syntax.\n";
+    return;
+  }
+  redraw();
+}
+
+/**
+ * @brief Compute the points of a specified equation, caching the results so
+ * the equation can be plotted again without being re-evaluated.
+ *
+ * @param equation int The index of the equation to compute.
+ * @return bool false if the render was cancelled before finishing.
+ */
+bool TGraph::computePoints(int equation) {
+  return computePoints(equation, ops[equation]);
+}
+
+/**
+ * @brief Compute the points of a specified equation using a different program
+ * (e.g. the residual program of an animation).
+ *
+ * @param equation int The index of the equation to compute.
+ * @param program std::vector<Operand>& the program computing the equation.
+ * @return bool false if the render was cancelled before finishing, leaving
+ * the equation partly computed.
+ */
+bool TGraph::computePoints(int equation, std::vector<Operand>& program) {
+  strides[equation] = VM::results(program);
+  samples[equation].resize(sampleColumns() * strides[equation]);
+  return computeColumns(equation, program, 0, sampleColumns());
+}
+
+/**
+ * @brief Computes the points of an equation in a range of columns of dots
+ * only, e.g. the columns exposed by a pan.
+ *
+ * @param equation int The index of the equation to compute.
+ * @param program std::vector<Operand>& the program computing the equation.
+ * @param first int the first column to compute.
+ * @param last int one past the last column to compute.
+ * @return bool false if the render was cancelled before finishing.
+ */
+bool TGraph::computeColumns(int equation,
+                            std::vector<Operand>& program,
+                            int first,
+                            int last) {
+  TG_TRACE("evaluate", equation);
+  AllocMeter meter(computing);
+  std::vector<double>& ys = samples[equation];
+  double xs[VM_BATCH];
+  for (int i = first; i < last; i += VM_BATCH) {
+    if (cancelled())
+      return false;
+    int n = std::min(VM_BATCH, last - i);
+    for (int k = 0; k < n; k++) {
+      // corrected x for matrix
+      xs[k] = sampleX(i + k);
+    }
+    vm.runBatch(program, xs, n, &ys[i * strides[equation]], i);
+  }
+  return true;
+}
+
+/**
+ * @brief Plots the cached points of a specified equation onto the screen, as
+ * its letter or as dots depending on the mode.
+ *
+ * @param equation int The index of the equation to plot.
+ */
+void TGraph::plotPoints(int equation) {
+  char symbol = plotSymbol(equation);
+  uint8_t colour = curveColour(equation);
+  size_t stride = strides[equation];
+  std::vector<double>& ys = samples[equation];
+  if (mode == PlotMode::ASCII) {
+    for (int i = 0; i < screenWidth; i++) {
+      for (size_t k = 0; k < stride; k++) {
+        // corrected y for matrix
+        int y = plotRow(ys[i * stride + k], screenHeight, stepY, originY);
+        if (y != -1) {
+          screen[y][i] = symbol;
+          colours[y * screenWidth + i] = colour;
+        }
+      }
+    }
+  } else {
+    int dotsX = plotDotsX(mode);
+    int dotsY = plotDotsY(mode);
+    for (int c = 0; c < sampleColumns(); c++) {
+      for (size_t k = 0; k < stride; k++) {
+        int r = plotDotRow(ys[c * stride + k], screenHeight, dotsY, stepY,
+                           originY);
+        if (r == -1)
+          continue;
+        int cell = r / dotsY * screenWidth + c / dotsX;
+        dots[cell] |= plotDotBit(c % dotsX, r % dotsY);
+        // text drawn over the dots keeps its own colour
+        if (screen[r / dotsY][c / dotsX] == ' ')
+          colours[cell] = colour;
+      }
+    }
+  }
+  writeToScreen("f(x) = ", 1, 5 + equation, colour);
+  writeToScreen(equations[equation], 8, 5 + equation, colour);
+}
+
+/**
+ * @brief Computes the min and max y of a dataset in each screen column, each
+ * column covering the x values closest to its centre.
+ *
+ * @param dataset int The index of the dataset to compute.
+ */
+void TGraph::computeData(int dataset) {
+  dataLows[dataset].resize(screenWidth);
+  dataHighs[dataset].resize(screenWidth);
+  computeDataColumns(dataset, 0, screenWidth);
+}
+
+/**
+ * @brief Computes the min and max y of a dataset in a range of columns only.
+ *
+ * @param dataset int The index of the dataset to compute.
+ * @param first int the first column to compute.
+ * @param last int one past the last column to compute.
+ */
+void TGraph::computeDataColumns(int dataset, int first, int last) {
+  AllocMeter meter(computing);
+  double left = plotX(first, screenWidth, stepX, originX) - stepX / 2;
+  datasets[dataset]->columns(left, stepX, last - first,
+                             &dataLows[dataset][first],
+                             &dataHighs[dataset][first]);
+}
+
+/**
+ * @brief Plots the cached column ranges of a dataset onto the screen as
+ * vertical spans.
+ *
+ * @param dataset int The index of the dataset to plot.
+ */
+void TGraph::plotData(int dataset) {
+  uint8_t colour = curveColour(equations.size() + dataset);
+  int dotsX = plotDotsX(mode);
+  int dotsY = plotDotsY(mode);
+  for (int i = 0; i < screenWidth; i++) {
+    if (std::isnan(dataLows[dataset][i]))
+      continue;
+    if (mode == PlotMode::ASCII) {
+      int top =
+          plotRowClamped(dataHighs[dataset][i], screenHeight, stepY, originY);
+      int bottom =
+          plotRowClamped(dataLows[dataset][i], screenHeight, stepY, originY);
+      for (int j = std::max(1, top); j <= std::min(screenHeight - 1, bottom);
+           j++) {
+        screen[j][i] = '#';
+        colours[j * screenWidth + i] = colour;
+      }
+      continue;
+    }
+    int top = plotDotRowClamped(dataHighs[dataset][i], screenHeight, dotsY,
+                                stepY, originY);
+    int bottom = plotDotRowClamped(dataLows[dataset][i], screenHeight, dotsY,
+                                   stepY, originY);
+    for (int r = std::max(dotsY, top);
+         r <= std::min(screenHeight * dotsY - 1, bottom); r++) {
+      for (int dx = 0; dx < dotsX; dx++) {
+        dots[r / dotsY * screenWidth + i] |= plotDotBit(dx, r % dotsY);
+      }
+      if (screen[r / dotsY][i] == ' ')
+        colours[r / dotsY * screenWidth + i] = colour;
+    }
+  }
+  const std::string& name = datasets[dataset]->getName();
+  int row = 5 + equations.size() + dataset;
+  char points[32];
+  snprintf(points, sizeof(points), " (%zu points)", datasets[dataset]->size());
+  writeToScreen("data: ", 1, row, colour);
+  writeToScreen(name, 7, row, colour);
+  writeToScreen(points, 7 + name.size(), row, colour);
+}
+
+/**
+ * @brief Adds an implicit plot or a heat map and draws it.
+ *
+ * @param kind FieldKind how the field is drawn.
+ * @param expression const std::string& the expression of x and y.
+ */
+void TGraph::addField(FieldKind kind, const std::string& expression) {
+  fields.push_back(std::make_unique<Field>(kind, expression, &env));
+  if (!compileField(fields.size() - 1)) {
+    fields.pop_back();
+    std::cout << "Invalid equation.\n";
+    return;
+  }
+  if (!computeField(fields.size() - 1)) {
+    dirty = true;
+    return;
+  }
+  redraw();
+}
+
+/**
+ * @brief (Re)compiles the expression of a field, recording which user
+ * definitions it depends on. An implicit plot may be written as an equation.
+ *
+ * @param field int the index of the field to compile.
+ * @return bool false if the expression has a syntax error.
+ */
+bool TGraph::compileField(int field) {
+  std::string expression = fields[field]->getExpression();
+  // lhs = rhs is plotted as lhs - rhs = 0, skipping ==, <=, >= and !=
+  size_t equals = expression.find('=');
+  while (equals != std::string::npos &&
+         ((equals > 0 && std::strchr("<>!=", expression[equals - 1])) ||
+          expression[equals + 1] == '='))
+    equals = expression.find('=', equals + 2);
+  if (fields[field]->getKind() == FieldKind::IMPLICIT &&
+      equals != std::string::npos)
+    expression = "(" + expression.substr(0, equals) + ") - (" +
+                 expression.substr(equals + 1) + ")";
+  std::vector<Token> tokens = scanner.scan(expression);
+  std::vector<std::string> names = scanner.getNames();
+  if (scanner.hadError() || tokens.empty())
+    return false;
+  std::vector<Operand> program = parser.parse(tokens);
+  if (parser.hadError())
+    return false;
+  names.insert(names.end(), parser.getNames().begin(),
+               parser.getNames().end());
+  fields[field]->setProgram(optimizer.polynomials(program), names);
+  return true;
+}
+
+/**
+ * @brief Evaluates a field over the view. Heat maps are evaluated at the
+ * centre of every cell, implicit plots at the corners of every dot so
+ * marching squares can tell which dots the contour crosses.
+ *
+ * @param field int the index of the field to compute.
+ * @return bool false if the render was cancelled before finishing.
+ */
+bool TGraph::computeField(int field) {
+  TG_TRACE("evaluate", field);
+  AllocMeter meter(computing);
+  auto superseded = [this] { return cancelled(); };
+  if (fields[field]->getKind() == FieldKind::HEAT) {
+    return fields[field]->sample(
+        plotX(0, screenWidth, stepX, originX),
+        plotDotY(0, screenHeight, 1, stepY, originY), stepX, stepY,
+        screenWidth, screenHeight, superseded);
+  }
+  int dotsY = plotDotsY(mode);
+  double dx = stepX / plotDotsX(mode);
+  double dy = stepY / dotsY;
+  return fields[field]->sample(
+      sampleX(0) - dx / 2,
+      plotDotY(0, screenHeight, dotsY, stepY, originY) + dy / 2, dx, dy,
+      sampleColumns() + 1, screenHeight * dotsY + 1, superseded);
+}
+
+/**
+ * @brief Evaluates every field over the view.
+ *
+ * @return bool false if the render was cancelled before finishing.
+ */
+bool TGraph::computeFields() {
+  for (size_t i = 0; i < fields.size(); i++) {
+    if (!computeField(i))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Plots a field onto the screen: a heat map as shading below
+ * everything else, an implicit plot as the dots (or, in ascii mode, the cells)
+ * its zero contour crosses, each cell getting a glyph along the contour.
+ *
+ * @param field int the index of the field to plot.
+ */
+void TGraph::plotField(int field) {
+  const Field& f = *fields[field];
+  int index = equations.size() + datasets.size() + field;
+  uint8_t colour = curveColour(index);
+  if (f.getKind() == FieldKind::HEAT) {
+    for (int j = 1; j < screenHeight; j++) {
+      for (int i = 0; i < screenWidth; i++) {
+        char shade = f.shade(i, j);
+        if (shade == ' ' || shades[j * screenWidth + i] != ' ')
+          continue;
+        shades[j * screenWidth + i] = shade;
+        colours[j * screenWidth + i] = colour;
+      }
+    }
+  } else if (mode == PlotMode::ASCII) {
+    for (int j = 1; j < screenHeight; j++) {
+      for (int i = 0; i < screenWidth; i++) {
+        int crossing = f.crossing(i, j);
+        if (crossing == 0)
+          continue;
+        screen[j][i] = Field::contourGlyph(crossing);
+        colours[j * screenWidth + i] = colour;
+      }
+    }
+  } else {
+    int dotsX = plotDotsX(mode);
+    int dotsY = plotDotsY(mode);
+    for (int r = dotsY; r < screenHeight * dotsY; r++) {
+      for (int c = 0; c < sampleColumns(); c++) {
+        if (f.crossing(c, r) == 0)
+          continue;
+        int cell = r / dotsY * screenWidth + c / dotsX;
+        dots[cell] |= plotDotBit(c % dotsX, r % dotsY);
+        if (screen[r / dotsY][c / dotsX] == ' ')
+          colours[cell] = colour;
+      }
+    }
+  }
+  std::string_view label =
+      f.getKind() == FieldKind::HEAT ? "heat: " : "implicit: ";
+  writeToScreen(label, 1, 5 + index, colour);
+  writeToScreen(f.getExpression(), 1 + label.size(), 5 + index, colour);
+}
+
+/**
+ * @brief Adds a parametric or polar curve and draws it.
+ *
+ * @param kind CurveKind whether the curve is parametric or polar.
+ * @param definition const std::string& x(t) = ..., y(t) = ... t0 t1 or
+ * r(theta) = ... [theta0 theta1].
+ */
+void TGraph::addCurve(CurveKind kind, const std::string& definition) {
+  curves.push_back(std::make_unique<Curve>(kind, definition, &env));
+  if (!compileCurve(curves.size() - 1)) {
+    curves.pop_back();
+    std::cout << "Invalid equation.\n";
+    return;
+  }
+  computeCurve(curves.size() - 1);
+  redraw();
+}
+
+/**
+ * @brief Splits the end of a curve definition into the body of the last
+ * definition and the bounds of its range. A space between two operands (not
+ * next to an operator, outside parentheses) starts the next part, and so does
+ * a sign right before an operand, e.g. "5 * cos(t) -pi 2 * pi" splits into
+ * "5 * cos(t)", "-pi" and "2 * pi".
+ *
+ * @param text const std::string& the text after the last =.
+ * @return std::vector<std::string> the body, then each bound.
+ */
+static std::vector<std::string> splitOperands(const std::string& text) {
+  const std::string operators = "+-*/^,?:<>=!";
+  std::vector<std::string> parts;
+  std::string part;
+  int depth = 0;
+  for (size_t i = 0; i < text.size(); i++) {
+    char c = text[i];
+    if (c == ' ' && depth == 0 && !part.empty()) {
+      size_t next = text.find_first_not_of(' ', i);
+      if (next == std::string::npos)
+        break;
+      char before = part.back();
+      char after = text[next];
+      bool sign = (after == '-' || after == '+') && next + 1 < text.size() &&
+                  text[next + 1] != ' ';
+      bool continues = operators.find(before) != std::string::npos ||
+                       before == '(' || after == ')' ||
+                       (operators.find(after) != std::string::npos && !sign);
+      if (!continues) {
+        parts.push_back(part);
+        part.clear();
+      }
+      i = next - 1;
+      if (continues)
+        part += ' ';
+      continue;
+    }
+    if (c == ' ' && part.empty())
+      continue;
+    depth += c == '(' ? 1 : c == ')' ? -1 : 0;
+    part += c;
+  }
+  if (!part.empty())
+    parts.push_back(part);
+  return parts;
+}
+
+/**
+ * @brief (Re)compiles a curve from its definition: x(t) = ..., y(t) = ...
+ * followed by the range of t, or r(theta) = ... optionally followed by the
+ * range of theta (0 to 2 pi by default). The range is a pair t0 t1 after the
+ * body of the last definition, see splitOperands. The programs of x and y
+ * are joined so one batched pass computes both.
+ *
+ * @param curve int the index of the curve to compile.
+ * @return bool false if the definition is invalid.
+ */
+bool TGraph::compileCurve(int curve) {
+  std::string rest = trim(curves[curve]->getExpression());
+  bool polar = curves[curve]->getKind() == CurveKind::POLAR;
+  std::vector<std::string> definitions;
+  if (polar) {
+    definitions.push_back(rest);
+  } else {
+    // the comma before y( separates the definitions of x and y
+    for (size_t split = rest.find("y("); split != std::string::npos;
+         split = rest.find("y(", split + 2)) {
+      size_t comma =
+          split == 0 ? split : rest.find_last_not_of(' ', split - 1);
+      if (split > 0 && comma != std::string::npos && rest[comma] == ',') {
+        definitions.push_back(rest.substr(0, comma));
+        definitions.push_back(rest.substr(split));
+        break;
+      }
+    }
+  }
+  if (definitions.empty())
+    return false;
+
+  // the range follows the body of the last definition
+  std::string& last = definitions.back();
+  size_t equals = last.find('=');
+  if (equals == std::string::npos)
+    return false;
+  std::vector<std::string> parts = splitOperands(last.substr(equals + 1));
+  double t0 = 0;
+  double t1 = 2 * M_PI;
+  if (parts.size() == 2) {
+    std::cout << "Expected both ends of the range.\n";
+    return false;
+  } else if (parts.size() > 3) {
+    std::cout << "Expected only a range after the curve.\n";
+    return false;
+  } else if (parts.size() == 3) {
+    for (int i = 1; i < 3; i++)
+      parts[i].erase(std::remove(parts[i].begin(), parts[i].end(), ' '),
+                     parts[i].end());
+    if (!evaluateConstant(parts[1], t0) || !evaluateConstant(parts[2], t1)) {
+      std::cout << "The range must be two constants.\n";
+      return false;
+    }
+  } else if (!polar) {
+    std::cout << "Expected the range of t after the curve.\n";
+    return false;
+  }
+  if (parts.empty())
+    return false;
+  last = last.substr(0, equals + 1) + parts[0];
+
+  const char* expected = polar ? "r" : "xy";
+  if (definitions.size() != std::strlen(expected))
+    return false;
+  std::vector<Operand> program;
+  std::vector<std::string> names;
+  for (size_t i = 0; i < definitions.size(); i++) {
+    // name(arg) = body
+    const std::string& definition = definitions[i];
+    size_t equals = definition.find('=');
+    size_t open = definition.find('(');
+    size_t close = definition.find(')');
+    if (equals == std::string::npos || open == std::string::npos ||
+        close == std::string::npos || open > close || close > equals)
+      return false;
+    std::string name = trim(definition.substr(0, open));
+    std::string arg = trim(definition.substr(open + 1, close - open - 1));
+    if (name.size() != 1 || name[0] != expected[i] || !isDefinable(arg))
+      return false;
+    std::vector<Operand> code;
+    if (!compileBody(definition.substr(equals + 1), arg, code, names) ||
+        VM::results(code) != 1)
+      return false;
+    program.insert(program.end(), code.begin(), code.end());
+  }
+  curves[curve]->setProgram(program, names, t0, t1);
+  return true;
+}
+
+/**
+ * @brief Compiles the body of a curve, its argument (t or theta) becoming the
+ * variable loaded by VAR.
+ *
+ * @param body const std::string& the expression.
+ * @param arg const std::string& the name of the argument.
+ * @param program std::vector<Operand>& receives the program.
+ * @param names std::vector<std::string>& receives the user-definable names it
+ * depends on.
+ * @return bool false if the expression is invalid.
+ */
+bool TGraph::compileBody(const std::string& body,
+                         const std::string& arg,
+                         std::vector<Operand>& program,
+                         std::vector<std::string>& names) {
+  std::vector<Token> tokens = scanner.scan(body, arg);
+  names.insert(names.end(), scanner.getNames().begin(),
+               scanner.getNames().end());
+  if (scanner.hadError() || tokens.empty())
+    return false;
+  std::vector<Operand> variable{OPCODE(OP::VAR)};
+  program = parser.parse(tokens, &variable);
+  if (parser.hadError() || VM::usesY(program))
+    return false;
+  names.insert(names.end(), parser.getNames().begin(),
+               parser.getNames().end());
+  program = optimizer.polynomials(program);
+  return true;
+}
+
+/**
+ * @brief Evaluates a constant expression, e.g. the bounds of a range.
+ *
+ * @param text const std::string& the expression, without spaces.
+ * @param value double& receives the value.
+ * @return bool false if the text is not a constant expression of numbers, pi
+ * and e (so the words of an equation are not mistaken for one).
+ */
+bool TGraph::evaluateConstant(const std::string& text, double& value) {
+  if (text.empty() ||
+      text.find_first_not_of("0123456789.+-*/^()pie") != std::string::npos ||
+      !std::strchr("0123456789.-(pe", text.front()) ||
+      !std::strchr("0123456789.)ie", text.back()))
+    return false;
+  std::vector<Token> tokens = scanner.scan(text);
+  if (scanner.hadError() || tokens.empty())
+    return false;
+  std::vector<Operand> program = parser.parse(tokens);
+  if (parser.hadError())
+    return false;
+  value = vm.run(program, 0).front();
+  return true;
+}
+
+/**
+ * @brief Samples a curve for the view.
+ *
+ * @param curve int the index of the curve to compute.
+ */
+void TGraph::computeCurve(int curve) {
+  TG_TRACE("evaluate", curve);
+  AllocMeter meter(computing);
+  int dotsX = plotDotsX(mode);
+  int dotsY = plotDotsY(mode);
+  curves[curve]->sample(sampleX(0),
+                        plotDotY(0, screenHeight, dotsY, stepY, originY),
+                        dotsX / stepX, dotsY / stepY, sampleColumns(),
+                        screenHeight * dotsY);
+}
+
+/**
+ * @brief Samples every curve for the view.
+ */
+void TGraph::computeCurves() {
+  for (size_t i = 0; i < curves.size(); i++) {
+    computeCurve(i);
+  }
+}
+
+/**
+ * @brief Plots the samples of a curve onto the screen like the points of an
+ * equation, joining samples a few dots apart with a line.
+ *
+ * @param curve int the index of the curve to plot.
+ */
+void TGraph::plotCurve(int curve) {
+  int index = equations.size() + datasets.size() + fields.size() + curve;
+  char symbol = plotSymbol(index);
+  uint8_t colour = curveColour(index);
+  int dotsX = plotDotsX(mode);
+  int dotsY = plotDotsY(mode);
+  auto put = [&](double column, double row) {
+    if (!(column >= -0.5 && column < sampleColumns() - 0.5 &&
+          row >= dotsY - 0.5 && row < screenHeight * dotsY - 0.5))
+      return;
+    int c = std::lround(column);
+    int r = std::lround(row);
+    int cell = r / dotsY * screenWidth + c / dotsX;
+    if (mode == PlotMode::ASCII) {
+      screen[r][c] = symbol;
+      colours[cell] = colour;
+      return;
+    }
+    dots[cell] |= plotDotBit(c % dotsX, r % dotsY);
+    if (screen[r / dotsY][c / dotsX] == ' ')
+      colours[cell] = colour;
+  };
+  const std::vector<double>& points = curves[curve]->getPoints();
+  for (size_t p = 0; p + 1 < points.size(); p += 2) {
+    double column = points[p];
+    double row = points[p + 1];
+    if (std::isnan(column))
+      continue;
+    put(column, row);
+    if (p == 0 || std::isnan(points[p - 2]))
+      continue;
+    double dc = column - points[p - 2];
+    double dr = row - points[p - 1];
+    double gap = std::max(std::fabs(dc), std::fabs(dr));
+    if (gap <= 1 || gap > CURVE_JOIN)
+      continue;
+    for (int s = 1; s < gap; s++) {
+      put(column - dc * s / gap, row - dr * s / gap);
+    }
+  }
+  std::string_view label = curves[curve]->getKind() == CurveKind::POLAR
+                               ? "polar: "
+                               : "param: ";
+  writeToScreen(label, 1, 5 + index, colour);
+  writeToScreen(curves[curve]->getExpression(), 1 + label.size(), 5 + index,
+                colour);
+}
+
+/**
+ * @brief Pans the view by whole columns and rows. The cached samples are
+ * shifted along with the view so only the columns it exposes are evaluated,
+ * and a vertical pan only re-projects the cached samples. Fields and curves
+ * cover the whole view, so they are evaluated again either way.
+ *
+ * @param columns int columns to pan right, negative to pan left.
+ * @param rows int rows to pan up, negative to pan down.
+ */
+void TGraph::pan(int columns, int rows) {
+  originX += columns * stepX;
+  originY += rows * stepY;
+  if (columns == 0 || dirty) {
+    if (!dirty && !computeFields()) {
+      dirty = true;
+      return;
+    }
+    computeCurves();
+    redraw();
+    return;
+  }
+  if (std::abs(columns) >= screenWidth) {
+    rerender();
+    return;
+  }
+  // the exposed columns are on the right when panning right
+  int kept = screenWidth - std::abs(columns);
+  int first = columns > 0 ? kept : 0;
+  int from = columns > 0 ? columns : 0;
+  int to = columns > 0 ? 0 : -columns;
+  // samples are kept per column of dots
+  int dotsX = plotDotsX(mode);
+  for (size_t e = 0; e < ops.size(); e++) {
+    double* ys = samples[e].data();
+    size_t row = strides[e] * dotsX;
+    std::memmove(ys + to * row, ys + from * row,
+                 kept * row * sizeof(double));
+  }
+  for (size_t d = 0; d < datasets.size(); d++) {
+    std::memmove(&dataLows[d][to], &dataLows[d][from], kept * sizeof(double));
+    std::memmove(&dataHighs[d][to], &dataHighs[d][from],
+                 kept * sizeof(double));
+  }
+  for (size_t e = 0; e < ops.size(); e++) {
+    if (!computeColumns(e, ops[e], first * dotsX,
+                        (first + screenWidth - kept) * dotsX)) {
+      dirty = true;
+      return;
+    }
+  }
+  for (size_t d = 0; d < datasets.size(); d++) {
+    computeDataColumns(d, first, first + screenWidth - kept);
+  }
+  if (!computeFields()) {
+    dirty = true;
+    return;
+  }
+  computeCurves();
+  redraw();
+}
+
+/**
+ * @brief Loads a dataset and plots it alongside the equations.
+ *
+ * @param filename const std::string& the CSV or raw float64 file.
+ */
+void TGraph::load(const std::string& filename) {
+  auto start = std::chrono::steady_clock::now();
+  std::unique_ptr<Dataset> dataset = std::make_unique<Dataset>();
+  if (!dataset->load(filename)) {
+    std::cout << "Could not load " << filename
+              << ", expected x,y pairs with increasing x.\n";
+    return;
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  datasets.push_back(std::move(dataset));
+  dataLows.emplace_back();
+  dataHighs.emplace_back();
+  computeData(datasets.size() - 1);
+  redraw();
+  std::cout << "Loaded " << datasets.back()->size() << " points in "
+            << elapsed.count() << "s.\n";
+}
+
+/**
+ * @brief Draws the last composed frame to the screen.
+ */
+void TGraph::draw(std::ostream& stream, bool colour) {
+  {
+    TG_TRACE("draw");
+    output.assign(1, '\n');
+    writer.encode(frame, colour ? &frameColours : nullptr, output);
+    stream.write(output.data(), output.size());
+    stream.flush();
+  }
+  Tracer::instance().nextFrame();
+}
+
+/**
+ * @brief Gets the glyph shown for a cell: text or a letter, else the dots of
+ * the cell, else heat map shading, else the axes.
+ *
+ * @param i int the column of the cell.
+ * @param j int the row of the cell.
+ * @return char32_t the glyph to show.
+ */
+char32_t TGraph::cellAt(int i, int j) const {
+  if (screen[j][i] != ' ')
+    return screen[j][i];
+  if (mode != PlotMode::ASCII && dots[j * screenWidth + i] != 0)
+    return plotDotGlyph(mode, dots[j * screenWidth + i]);
+  char shade = shades[j * screenWidth + i];
+  if (shade != ' ' && shade != 0)
+    return shade;
+  return axisGlyph(i, j, screenWidth, screenHeight,
+                   (int)std::lround(originX / stepX),
+                   (int)std::lround(originY / stepY));
+}
+
+/**
+ * @brief Composes the final glyphs of the screen into the part of frame the
+ * loaded pane covers, with the separators left of and above it, for
+ * presenting with the terminal writer. The other panes are left as they were.
+ */
+void TGraph::compose() {
+  TG_TRACE("compose");
+  frame.resize(terminalHeight);
+  frameColours.resize(terminalHeight);
+  for (int j = 0; j < terminalHeight; j++) {
+    frame[j].resize(terminalWidth, U' ');
+    frameColours[j].resize(terminalWidth);
+  }
+  const Pane& pane = panes[focused];
+  int width = std::min(screenWidth, terminalWidth - pane.left);
+  int height = std::min(screenHeight, terminalHeight - pane.top);
+  for (int j = 0; j < height; j++) {
+    for (int i = 0; i < width; i++) {
+      frame[pane.top + j][pane.left + i] = cellAt(i, j);
+      frameColours[pane.top + j][pane.left + i] =
+          colours[j * screenWidth + i];
+    }
+  }
+  if (pane.top > 0) {
+    for (int i = std::max(0, pane.left - 1); i < pane.left + width; i++) {
+      frame[pane.top - 1][i] = U'\u2500';
+      frameColours[pane.top - 1][i] = 0;
+    }
+  }
+  if (pane.left > 0) {
+    for (int j = 0; j < height; j++) {
+      frame[pane.top + j][pane.left - 1] = U'\u2502';
+      frameColours[pane.top + j][pane.left - 1] = 0;
+    }
+  }
+}
+
+/**
+ * @brief Clears the 2d screen array and the dots and writes the header. The
+ * arrays are only reallocated when the size of the screen changed.
+ */
+void TGraph::resetScreen() {
+  screen.resize(screenHeight);
+  for (std::vector<char>& row : screen) {
+    row.assign(screenWidth, ' ');
+  }
+  dots.assign(mode == PlotMode::ASCII ? 0 : screenWidth * screenHeight, 0);
+  colours.assign(screenWidth * screenHeight, 0);
+  shades.assign(screenWidth * screenHeight, ' ');
+
+  char line[128];
+  snprintf(line, sizeof(line), "TGraph v%d.%d", VERSION_MAJOR, VERSION_MINOR);
+  if (panes.size() > 1)
+    snprintf(line, sizeof(line), "TGraph v%d.%d, pane %d%s", VERSION_MAJOR,
+             VERSION_MINOR, focused + 1, focused == active ? " (active)" : "");
+  writeToScreen(line, 1, 1);
+  snprintf(line, sizeof(line), "x-step: %f, center x: %f", stepX, originX);
+  writeToScreen(line, 1, 2);
+  snprintf(line, sizeof(line), "y-step: %f, center y: %f", stepY, originY);
+  writeToScreen(line, 1, 3);
+  writeToScreen("Equations:", 1, 4);
+}
+
+/**
+ * @brief Re-renders the 2d screen array (for when zooming happens, etc.) If a
+ * newer command cancels it, the graph is marked dirty and nothing is drawn.
+ */
+void TGraph::rerender() {
+  for (size_t i = 0; i < datasets.size(); i++) {
+    computeData(i);
+  }
+  everyEquation.resize(ops.size());
+  for (size_t i = 0; i < ops.size(); i++) {
+    everyEquation[i] = i;
+  }
+  dirty = false;
+  if (!computeEquations(everyEquation) || !computeFields()) {
+    dirty = true;
+    return;
+  }
+  computeCurves();
+
+  redraw();
+}
+
+/**
+ * @brief Computes equations progressively, first every 8th column, then the
+ * columns halfway between those, and so on until every column is computed.
+ * A pass is drawn as soon as it completes (each column held across the gap
+ * to the next computed one) if the passes left are expected to take long
+ * enough to be worth showing it, so cheap equations are drawn once.
+ *
+ * @param targets const std::vector<int>& the equations to compute.
+ * @return bool false if a newer command cancelled the remaining passes.
+ */
+bool TGraph::refine(const std::vector<int>& targets) {
+  {
+    AllocMeter meter(computing);
+    for (int e : targets) {
+      strides[e] = VM::results(ops[e]);
+      samples[e].resize(sampleColumns() * strides[e]);
+    }
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = REFINE_STRIDE; pass >= 1; pass /= 2) {
+    for (int e : targets) {
+      if (!computePass(e, pass))
+        return false;
+    }
+    if (pass == 1 || dirty)
+      continue;
+    // a pass with stride n covers 1/n of the work
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() * (pass - 1) >= REFINE_FRAME_MS)
+      redraw();
+  }
+  return true;
+}
+
+/**
+ * @brief Computes one pass of a progressive render: the columns that are
+ * multiples of pass but were not computed by the coarser passes before it.
+ * Every other column then holds the value of the computed column to its
+ * left, until a finer pass replaces it.
+ *
+ * @param equation int The index of the equation to compute.
+ * @param pass int the stride of the pass, a power of two.
+ * @return bool false if the render was cancelled before finishing.
+ */
+bool TGraph::computePass(int equation, int pass) {
+  TG_TRACE("evaluate", equation);
+  AllocMeter meter(computing);
+  std::vector<double>& ys = samples[equation];
+  size_t stride = strides[equation];
+  // the coarsest pass starts at column 0, the others fill in between
+  int first = pass == REFINE_STRIDE ? 0 : pass;
+  int step = pass == REFINE_STRIDE ? pass : 2 * pass;
+  double xs[VM_BATCH];
+  int columns[VM_BATCH];
+  passResults.resize(VM_BATCH * stride);
+  double* out = passResults.data();
+  int width = sampleColumns();
+  for (int i = first; i < width;) {
+    if (cancelled())
+      return false;
+    int n = 0;
+    for (; n < VM_BATCH && i < width; n++, i += step) {
+      columns[n] = i;
+      xs[n] = sampleX(i);
+    }
+    vm.runBatch(ops[equation], xs, n, out);
+    for (int k = 0; k < n; k++) {
+      std::memcpy(&ys[columns[k] * stride], &out[k * stride],
+                  stride * sizeof(double));
+    }
+  }
+  if (pass > 1) {
+    for (int i = 0; i < width; i++) {
+      if (i % pass != 0)
+        std::memcpy(&ys[i * stride], &ys[(i - i % pass) * stride],
+                    stride * sizeof(double));
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Computes equations for the view, progressively (see refine) when
+ * the terminal is not split and for every pane at once when it is.
+ *
+ * @param targets const std::vector<int>& the equations to compute.
+ * @return bool false if a newer command cancelled the computation.
+ */
+bool TGraph::computeEquations(const std::vector<int>& targets) {
+  if (panes.size() == 1)
+    return refine(targets);
+  return computePanes(targets);
+}
+
+/**
+ * @brief Computes equations for every pane, the panes in parallel. Panes are
+ * taken from the finest column spacing to the coarsest, and a pane whose
+ * columns land on the columns of a finer (or equal) pane, e.g. a zoomed out
+ * or panned copy of it, is computed after it, copying the samples of the
+ * columns they share and evaluating only the others.
+ *
+ * @param targets const std::vector<int>& the equations to compute.
+ * @return bool false if a newer command cancelled the computation.
+ */
+bool TGraph::computePanes(const std::vector<int>& targets) {
+  TG_TRACE("panes");
+  AllocMeter meter(computing);
+  int dotsX = plotDotsX(mode);
+  // the loaded view is stored with the others while they are computed
+  swapView(panes[focused].view);
+  std::vector<int> order(panes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return panes[a].view.stepX < panes[b].view.stepX;
+  });
+  std::vector<int> sources, reusing;
+  for (size_t i = 0; i < order.size(); i++) {
+    bool reuses = false;
+    int scale;
+    long offset;
+    for (size_t j = 0; j < i && !reuses; j++) {
+      reuses = aligned(panes[order[j]].view, panes[order[i]].view, dotsX,
+                       scale, offset);
+    }
+    (reuses ? reusing : sources).push_back(order[i]);
+  }
+  std::atomic<bool> abandoned{false};
+  std::vector<int> none;
+  for (const std::vector<int>* stage : {&sources, &reusing}) {
+    parallelFor(stage->size(), [&](unsigned worker, size_t i) {
+      if (abandoned.load(std::memory_order_relaxed) ||
+          !computePane((*stage)[i], targets,
+                       stage == &reusing ? sources : none, paneVMs[worker]))
+        abandoned = true;
+    });
+  }
+  swapView(panes[focused].view);
+  return !abandoned;
+}
+
+/**
+ * @brief Computes equations for the stored view of a pane, copying the
+ * columns that line up with the columns of a source pane.
+ *
+ * @param pane int the index of the pane.
+ * @param targets const std::vector<int>& the equations to compute, those the
+ * pane does not show are skipped.
+ * @param sources const std::vector<int>& panes already computed.
+ * @param machine VM& the VM of the worker.
+ * @return bool false if the render was cancelled before finishing.
+ */
+bool TGraph::computePane(int pane,
+                         const std::vector<int>& targets,
+                         const std::vector<int>& sources,
+                         VM& machine) {
+  View& view = panes[pane].view;
+  int dotsX = plotDotsX(mode);
+  int width = view.screenWidth * dotsX;
+  view.samples.resize(ops.size());
+  view.strides.resize(ops.size());
+  double xs[VM_BATCH];
+  int columns[VM_BATCH];
+  std::vector<double> out;
+  for (int e : targets) {
+    if (!visible(view.shown, e))
+      continue;
+    size_t stride = VM::results(ops[e]);
+    view.strides[e] = stride;
+    std::vector<double>& ys = view.samples[e];
+    ys.resize(width * stride);
+    const View* from = nullptr;
+    int scale = 1;
+    long offset = 0;
+    for (int s : sources) {
+      const View& source = panes[s].view;
+      if (visible(source.shown, e) &&
+          aligned(source, view, dotsX, scale, offset)) {
+        from = &source;
+        break;
+      }
+    }
+    long reusable = from ? (long)from->screenWidth * dotsX : 0;
+    out.resize(VM_BATCH * stride);
+    int n = 0;
+    for (int c = 0; c <= width; c++) {
+      // evaluate a full batch, or the last one
+      if (n == VM_BATCH || (c == width && n > 0)) {
+        if (cancelled())
+          return false;
+        machine.runBatch(ops[e], xs, n, out.data());
+        for (int k = 0; k < n; k++) {
+          std::memcpy(&ys[columns[k] * stride], &out[k * stride],
+                      stride * sizeof(double));
+        }
+        n = 0;
+      }
+      if (c == width)
+        break;
+      long k = offset + (long)scale * c;
+      if (k >= 0 && k < reusable) {
+        std::memcpy(&ys[c * stride], &from->samples[e][k * stride],
+                    stride * sizeof(double));
+        continue;
+      }
+      columns[n] = c;
+      xs[n++] = plotDotX(c, view.screenWidth, dotsX, view.stepX, view.originX);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Plots and composes every pane, the active pane last so the shared
+ * field grids and curve samples are left computed for its view. Datasets,
+ * fields and curves are computed for each pane as it is plotted.
+ *
+ * @return bool false if the render was cancelled before finishing.
+ */
+bool TGraph::plotPanes() {
+  auto plotPane = [this](int pane) {
+    focus(pane);
+    dataLows.resize(datasets.size());
+    dataHighs.resize(datasets.size());
+    for (size_t d = 0; d < datasets.size(); d++) {
+      computeData(d);
+    }
+    if (!computeFields())
+      return false;
+    computeCurves();
+    plot();
+    compose();
+    return true;
+  };
+  bool done = true;
+  for (size_t p = 0; p < panes.size() && done; p++) {
+    if ((int)p != active)
+      done = plotPane(p);
+  }
+  done = done && plotPane(active);
+  focus(active);
+  return done;
+}
+
+/**
+ * @brief Splits the active pane in two, the new pane getting the same view
+ * and equations, and makes the new pane active.
+ *
+ * @param horizontal bool true to split side by side, false to split one
+ * above the other.
+ */
+void TGraph::split(bool horizontal) {
+  Pane pane = panes[active];
+  double span = horizontal ? (pane.x1 - pane.x0) * terminalWidth
+                           : (pane.y1 - pane.y0) * terminalHeight;
+  if (span / 2 - 1 < (horizontal ? PANE_MIN_WIDTH : PANE_MIN_HEIGHT)) {
+    std::cout << "Pane too small to split.\n";
+    return;
+  }
+  if (horizontal)
+    panes[active].x1 = pane.x0 = (pane.x0 + pane.x1) / 2;
+  else
+    panes[active].y1 = pane.y0 = (pane.y0 + pane.y1) / 2;
+  pane.view = View();
+  pane.view.stepX = stepX;
+  pane.view.stepY = stepY;
+  pane.view.originX = originX;
+  pane.view.originY = originY;
+  pane.view.shown = shown;
+  panes.insert(panes.begin() + active + 1, pane);
+  focus(active + 1);
+  active = focused;
+  layout();
+  rerender();
+}
+
+/**
+ * @brief Checks if a word is a pane or equation number, short enough that
+ * std::stoi cannot overflow on it.
+ *
+ * @param word const std::string& the word.
+ * @return bool true if it is 1 to 9 digits.
+ */
+static bool isIndex(const std::string& word) {
+  return !word.empty() && word.size() <= 9 &&
+         word.find_first_not_of("0123456789") == std::string::npos;
+}
+
+/**
+ * @brief Handles a pane command: lists the panes, makes a pane active, or
+ * also chooses the equations it shows (pane 2 1 3, or pane 2 all).
+ *
+ * @param tokens const std::vector<std::string>& the words of the command.
+ */
+void TGraph::selectPane(const std::vector<std::string>& tokens) {
+  if (tokens.size() == 1) {
+    char line[128];
+    for (size_t p = 0; p < panes.size(); p++) {
+      focus(p);
+      snprintf(line, sizeof(line),
+               "%zu: %dx%d, x-step: %f, y-step: %f, center: %f, %f%s\n",
+               p + 1, screenWidth, screenHeight, stepX, stepY, originX,
+               originY, (int)p == active ? " (active)" : "");
+      std::cout << line;
+    }
+    focus(active);
+    return;
+  }
+  if (!isIndex(tokens[1]) ||
+      (tokens.size() > 3 && tokens[2].compare("all") == 0)) {
+    std::cout << "Invalid command syntax.\n";
+    return;
+  }
+  int pane = std::stoi(tokens[1]);
+  if (pane < 1 || pane > (int)panes.size()) {
+    std::cout << "No such pane.\n";
+    return;
+  }
+  std::vector<char> subset;
+  if (tokens.size() > 2 && tokens[2].compare("all") != 0) {
+    subset.assign(ops.size(), 0);
+    for (size_t i = 2; i < tokens.size(); i++) {
+      if (!isIndex(tokens[i])) {
+        std::cout << "Invalid command syntax.\n";
+        return;
+      }
+      size_t equation = std::stoul(tokens[i]);
+      if (equation < 1 || equation > ops.size()) {
+        std::cout << "No such equation.\n";
+        return;
+      }
+      subset[equation - 1] = 1;
+    }
+  }
+  focus(pane - 1);
+  active = focused;
+  if (tokens.size() == 2) {
+    redraw();
+    return;
+  }
+  shown = subset;
+  rerender();
+}
+
+/**
+ * @brief Plots everything onto the cleared screen of the loaded view.
+ */
+void TGraph::plot() {
+  resetScreen();
+  for (size_t i = 0; i < fields.size(); i++) {
+    plotField(i);
+  }
+  for (size_t i = 0; i < ops.size(); i++) {
+    if (visible(shown, i))
+      plotPoints(i);
+  }
+  for (size_t i = 0; i < curves.size(); i++) {
+    plotCurve(i);
+  }
+  for (size_t i = 0; i < datasets.size(); i++) {
+    plotData(i);
+  }
+}
+
+/**
+ * @brief Redraws the graph from the cached points without re-evaluating any
+ * equations, unless an abandoned render left them stale. When the terminal
+ * is split, fields and curves are computed again for each pane.
+ */
+void TGraph::redraw() {
+  if (dirty) {
+    rerender();
+    return;
+  }
+  if (!headless) {
+#ifdef TG_WINDOWS
+    system("cls");
+#endif
+#ifdef TG_LINUX
+    system("clear");
+#endif
+  }
+  frameAllocs.compute = computing;
+  frameAllocs.plot = frameAllocs.draw = computing = AllocCount{};
+  {
+    AllocMeter meter(frameAllocs.plot);
+    if (panes.size() > 1) {
+      if (!plotPanes()) {
+        dirty = true;
+        return;
+      }
+    } else {
+      plot();
+      compose();
+    }
+  }
+
+  {
+    AllocMeter meter(frameAllocs.draw);
+    // a headless replay still encodes the frame, but sends it nowhere
+    static std::ostream discard(nullptr);
+    draw(headless ? discard : std::cout, true);
+  }
+  frameAllocs.frames++;
+  if (frameAllocs.compute.allocations + frameAllocs.plot.allocations +
+          frameAllocs.draw.allocations >
+      ALLOC_FRAME_BUDGET)
+    frameAllocs.overBudget++;
+}
+
+/**
+ * @brief Parses an equation string and adds it to the list of equations.
+ *
+ * @param equation std::string The equation to add.
+ * @return bool true if the equation was valid and added.
+ */
+bool TGraph::parseEquation(std::string& equation) {
+  ops.emplace_back();
+  equations.push_back(equation);
+  deps.emplace_back();
+  samples.emplace_back();
+  strides.push_back(0);
+  bool valid = compile(ops.size() - 1);
+  if (valid && VM::usesY(ops.back())) {
+    std::cout << "y is only defined in implicit and heat plots.\n";
+    valid = false;
+  }
+  if (!valid) {
+    ops.pop_back();
+    equations.pop_back();
+    deps.pop_back();
+    samples.pop_back();
+    strides.pop_back();
+    return false;
+  }
+#ifdef TG_DEBUG
+  parser.printOPs(ops.back());
+#endif
+  return true;
+}
+
+/**
+ * @brief (Re)compiles an equation from its source, recording which user
+ * definitions it depends on.
+ *
+ * @param equation int the index of the equation to compile.
+ * @return bool false if the equation has a syntax error.
+ */
+bool TGraph::compile(int equation) {
+  std::vector<Token> tokens;
+  {
+    TG_TRACE("scan", equation);
+    tokens = scanner.scan(equations[equation]);
+  }
+  deps[equation] = scanner.getNames();
+  if (scanner.hadError() || tokens.empty())
+    return false;
+  {
+    TG_TRACE("parse", equation);
+    ops[equation] = parser.parse(tokens);
+  }
+  deps[equation].insert(deps[equation].end(), parser.getNames().begin(),
+                        parser.getNames().end());
+  if (parser.hadError())
+    return false;
+  TG_TRACE("optimize", equation);
+  ops[equation] = optimizer.polynomials(ops[equation]);
+  return true;
+}
+
+/**
+ * @brief Checks if a list of names references one of the given names.
+ *
+ * @param names const std::vector<std::string>& the names referenced.
+ * @param changed const std::vector<std::string>& the names to look for.
+ * @return bool true if any name is referenced.
+ */
+static bool references(const std::vector<std::string>& names,
+                       const std::vector<std::string>& changed) {
+  for (const std::string& name : changed) {
+    if (std::find(names.begin(), names.end(), name) != names.end())
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Evaluates the body of a parameter.
+ *
+ * @param body const std::string& the expression.
+ * @param value double& receives the value.
+ * @param names std::vector<std::string>& receives the user-definable names it
+ * references.
+ * @return bool false (after saying why) if the body is invalid, depends on x
+ * or y, or does not have exactly one value.
+ */
+bool TGraph::evaluateParam(const std::string& body,
+                           double& value,
+                           std::vector<std::string>& names) {
+  std::vector<Token> tokens = scanner.scan(body);
+  names = scanner.getNames();
+  if (scanner.hadError() || tokens.empty()) {
+    std::cout << "Invalid expression.\n";
+    return false;
+  }
+  std::vector<Operand> program = parser.parse(tokens);
+  if (parser.hadError()) {
+    std::cout << "Invalid expression.\n";
+    return false;
+  }
+  names.insert(names.end(), parser.getNames().begin(),
+               parser.getNames().end());
+  if (VM::usesX(program) || VM::usesY(program)) {
+    std::cout << "A parameter cannot depend on x or y.\n";
+    return false;
+  }
+  std::vector<double> values = vm.run(program, 0);
+  if (values.size() != 1) {
+    std::cout << "A parameter must have exactly one value.\n";
+    return false;
+  }
+  value = values.front();
+  return true;
+}
+
+/**
+ * @brief Handles a let command, defining a parameter (let a = 3) or a function
+ * (let g(t) = t^2 + a). A parameter keeps its body and is re-evaluated when a
+ * name it references changes, so let b = 2*a follows a.
+ *
+ * @param definition const std::string& the definition without the let.
+ */
+void TGraph::define(const std::string& definition) {
+  size_t equals = definition.find('=');
+  if (equals == std::string::npos) {
+    std::cout << "Invalid command syntax.\n";
+    return;
+  }
+  std::string name = trim(definition.substr(0, equals));
+  std::string body = trim(definition.substr(equals + 1));
+  std::string arg{""};
+  size_t open = name.find('(');
+  if (open != std::string::npos) {
+    size_t close = name.find(')');
+    if (close == std::string::npos || close < open) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    arg = trim(name.substr(open + 1, close - open - 1));
+    name = trim(name.substr(0, open));
+    if (!isDefinable(arg)) {
+      std::cout << "Invalid argument name: " << arg << "\n";
+      return;
+    }
+  }
+  if (!isDefinable(name)) {
+    std::cout << "Invalid name: " << name << "\n";
+    return;
+  }
+  if (body.empty()) {
+    std::cout << "Invalid command syntax.\n";
+    return;
+  }
+
+  int existing = env.resolve(name);
+  if (open == std::string::npos) {
+    double value;
+    std::vector<std::string> names;
+    if (!evaluateParam(body, value, names))
+      return;
+    // follow the parameters it references, one of them leading back to it
+    // would be re-evaluated forever
+    std::vector<std::string> reached = names;
+    for (size_t i = 0; i < reached.size(); i++) {
+      if (reached[i] == name) {
+        std::cout << name << " cannot depend on itself.\n";
+        return;
+      }
+      int symbol = env.resolve(reached[i]);
+      if (symbol == -1 || env.get(symbol).kind != SymbolKind::PARAM)
+        continue;
+      for (const std::string& dep : env.get(symbol).deps) {
+        if (std::find(reached.begin(), reached.end(), dep) == reached.end())
+          reached.push_back(dep);
+      }
+    }
+    // dependents of an existing parameter only need re-evaluating
+    bool recompile =
+        existing == -1 || env.get(existing).kind != SymbolKind::PARAM;
+    env.defineParam(name, value, body, names);
+    updateDependents(name, recompile);
+  } else {
+    env.defineFunction(name, arg, body);
+    updateDependents(name, true);
+  }
+}
+
+/**
+ * @brief Re-evaluates the parameters evaluated from a changed definition (and
+ * the ones evaluated from those), then recomputes only the equations (and
+ * fields and curves) that depend on any of them and redraws the graph from
+ * the cached points.
+ *
+ * @param name const std::string& the name of the changed definition.
+ * @param recompile bool true if the dependents must also be recompiled.
+ */
+void TGraph::updateDependents(const std::string& name, bool recompile) {
+  std::vector<std::string> changed{name};
+  for (size_t k = 0; k < changed.size(); k++) {
+    for (size_t s = 0; s < env.size(); s++) {
+      Symbol symbol = env.get(s);
+      if (symbol.kind != SymbolKind::PARAM ||
+          !references(symbol.deps, {changed[k]}) ||
+          references(changed, {symbol.name}))
+        continue;
+      double value;
+      std::vector<std::string> names;
+      // an invalid body keeps the last value
+      if (evaluateParam(symbol.body, value, names))
+        env.defineParam(symbol.name, value, symbol.body, names);
+      changed.push_back(symbol.name);
+    }
+  }
+
+  std::vector<int> dependents;
+  for (size_t i = 0; i < equations.size(); i++) {
+    if (!references(deps[i], changed))
+      continue;
+    if (recompile)
+      compile(i);
+    dependents.push_back(i);
+  }
+  std::vector<int> dependentFields;
+  for (size_t i = 0; i < fields.size(); i++) {
+    const std::vector<std::string>& names = fields[i]->getDeps();
+    if (!references(names, changed))
+      continue;
+    if (recompile)
+      compileField(i);
+    dependentFields.push_back(i);
+  }
+  std::vector<int> dependentCurves;
+  for (size_t i = 0; i < curves.size(); i++) {
+    const std::vector<std::string>& names = curves[i]->getDeps();
+    if (!references(names, changed))
+      continue;
+    if (recompile)
+      compileCurve(i);
+    dependentCurves.push_back(i);
+  }
+  if (dependents.empty() && dependentFields.empty() && dependentCurves.empty())
+    return;
+  if (!computeEquations(dependents)) {
+    dirty = true;
+    return;
+  }
+  for (int i : dependentFields) {
+    if (!computeField(i)) {
+      dirty = true;
+      return;
+    }
+  }
+  for (int i : dependentCurves) {
+    computeCurve(i);
+  }
+  redraw();
+}
+
+/**
+ * @brief Handles a watch command: loads a file of equations and commands,
+ * one per line (blank lines and lines starting with # are skipped), and
+ * reloads it whenever it is written.
+ *
+ * @param filename const std::string& the file to watch.
+ */
+void TGraph::watch(const std::string& filename) {
+  if (!watcher.open(filename)) {
+    std::cout << "Could not open file: " << filename << "\n";
+    return;
+  }
+  // lines of a file watched before stay, they just stop following it
+  watched.clear();
+  reloadWatched();
+}
+
+/**
+ * @brief Reloads the watched file, diffing its lines against the last load.
+ * Unchanged lines keep their compiled equations and cached samples. The
+ * equations, fields, curves and datasets the removed and changed lines added
+ * are removed, and the new and changed lines are run, what they add taking
+ * the places of the ones they replace so they keep their colours. Other
+ * commands (let, mode, xstep, ...) are not undone when their line is
+ * removed. The new equations are computed together and the graph redrawn
+ * once.
+ */
+void TGraph::reloadWatched() {
+  std::ifstream in(watcher.getPath());
+  if (!in) {
+    std::cout << "Could not read file: " << watcher.getPath() << "\n";
+    return;
+  }
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    line = trim(line);
+    std::string word = line.substr(0, line.find(' '));
+    // these would stop or restart the watch
+    if (line.empty() || line[0] == '#' || word == "watch" ||
+        word == "clear" || word == "exit")
+      continue;
+    lines.push_back(line);
+  }
+
+  // match the unchanged lines by the longest common subsequence, lcs[i][j]
+  // is its length for the lines from i and j on
+  size_t n = watched.size(), m = lines.size();
+  std::vector<std::vector<int>> lcs(n + 1, std::vector<int>(m + 1, 0));
+  for (size_t i = n; i-- > 0;) {
+    for (size_t j = m; j-- > 0;) {
+      lcs[i][j] = watched[i].text == lines[j]
+                      ? lcs[i + 1][j + 1] + 1
+                      : std::max(lcs[i + 1][j], lcs[i][j + 1]);
+    }
+  }
+  std::vector<WatchedLine> next(m);
+  std::vector<char> added(m, 1);
+  std::vector<WatchedLine> removed;
+  size_t i = 0, j = 0;
+  while (i < n || j < m) {
+    if (i < n && j < m && watched[i].text == lines[j]) {
+      next[j] = watched[i++];
+      added[j++] = 0;
+    } else if (j == m || (i < n && lcs[i + 1][j] >= lcs[i][j + 1])) {
+      removed.push_back(watched[i++]);
+    } else {
+      next[j].text = lines[j];
+      j++;
+    }
+  }
+  if (removed.empty() && std::count(added.begin(), added.end(), 1) == 0)
+    return;
+  watched = next;
+
+  // removed from the last equation down, so the other indices stay valid
+  std::sort(removed.begin(), removed.end(),
+            [](const WatchedLine& a, const WatchedLine& b) {
+              return a.equation > b.equation;
+            });
+  for (const WatchedLine& old : removed) {
+    if (old.equation >= 0)
+      removeEquation(old.equation);
+    fields.erase(std::remove_if(fields.begin(), fields.end(),
+                                [&](const std::unique_ptr<Field>& field) {
+                                  return field.get() == old.field;
+                                }),
+                 fields.end());
+    curves.erase(std::remove_if(curves.begin(), curves.end(),
+                                [&](const std::unique_ptr<Curve>& curve) {
+                                  return curve.get() == old.curve;
+                                }),
+                 curves.end());
+    for (size_t d = 0; d < datasets.size(); d++) {
+      if (datasets[d].get() != old.dataset)
+        continue;
+      datasets.erase(datasets.begin() + d);
+      dataLows.erase(dataLows.begin() + d);
+      dataHighs.erase(dataHighs.begin() + d);
+      break;
+    }
+  }
+
+  // new lines are placed after what the lines above them added
+  int equationAt = -1;
+  size_t fieldAt = 0, curveAt = 0, datasetAt = 0;
+  for (size_t k = 0; k < m; k++) {
+    WatchedLine& entry = watched[k];
+    if (!added[k]) {
+      if (entry.equation >= 0)
+        equationAt = entry.equation + 1;
+      for (size_t f = 0; f < fields.size(); f++) {
+        if (fields[f].get() == entry.field)
+          fieldAt = f + 1;
+      }
+      for (size_t c = 0; c < curves.size(); c++) {
+        if (curves[c].get() == entry.curve)
+          curveAt = c + 1;
+      }
+      for (size_t d = 0; d < datasets.size(); d++) {
+        if (datasets[d].get() == entry.dataset)
+          datasetAt = d + 1;
+      }
+      continue;
+    }
+    if (isCommand(entry.text.substr(0, entry.text.find(' ')))) {
+      size_t fieldCount = fields.size(), curveCount = curves.size();
+      size_t datasetCount = datasets.size();
+      parseInput(entry.text);
+      if (fields.size() > fieldCount) {
+        std::rotate(fields.begin() + fieldAt, fields.end() - 1, fields.end());
+        entry.field = fields[fieldAt++].get();
+      }
+      if (curves.size() > curveCount) {
+        std::rotate(curves.begin() + curveAt, curves.end() - 1, curves.end());
+        entry.curve = curves[curveAt++].get();
+      }
+      if (datasets.size() > datasetCount) {
+        std::rotate(datasets.begin() + datasetAt, datasets.end() - 1,
+                    datasets.end());
+        std::rotate(dataLows.begin() + datasetAt, dataLows.end() - 1,
+                    dataLows.end());
+        std::rotate(dataHighs.begin() + datasetAt, dataHighs.end() - 1,
+                    dataHighs.end());
+        entry.dataset = datasets[datasetAt++].get();
+      }
+      continue;
+    }
+    std::string equation = entry.text;
+    if (!parseEquation(equation)) {
+      std::cout << "Invalid equation on line " << k + 1 << ": " << entry.text
+                << "\n";
+      continue;
+    }
+    // before the first watched equation if none is above
+    if (equationAt < 0) {
+      equationAt = ops.size() - 1;
+      for (const WatchedLine& other : watched) {
+        if (other.equation >= 0)
+          equationAt = std::min(equationAt, other.equation);
+      }
+    }
+    moveLastEquation(equationAt);
+    entry.equation = equationAt++;
+  }
+
+  std::vector<int> targets;
+  for (size_t k = 0; k < m; k++) {
+    if (added[k] && watched[k].equation >= 0)
+      targets.push_back(watched[k].equation);
+  }
+  if (!computeEquations(targets)) {
+    dirty = true;
+    return;
+  }
+  redraw();
+}
+
+/**
+ * @brief Removes an equation and its samples in every pane.
+ *
+ * @param equation int the index of the equation.
+ */
+void TGraph::removeEquation(int equation) {
+  ops.erase(ops.begin() + equation);
+  equations.erase(equations.begin() + equation);
+  deps.erase(deps.begin() + equation);
+  samples.erase(samples.begin() + equation);
+  strides.erase(strides.begin() + equation);
+  if ((int)shown.size() > equation)
+    shown.erase(shown.begin() + equation);
+  for (size_t p = 0; p < panes.size(); p++) {
+    View& view = panes[p].view;
+    if ((int)p == focused)
+      continue;
+    if ((int)view.samples.size() > equation) {
+      view.samples.erase(view.samples.begin() + equation);
+      view.strides.erase(view.strides.begin() + equation);
+    }
+    if ((int)view.shown.size() > equation)
+      view.shown.erase(view.shown.begin() + equation);
+  }
+  for (WatchedLine& entry : watched) {
+    if (entry.equation > equation)
+      entry.equation--;
+  }
+}
+
+/**
+ * @brief Moves the equation added last to an earlier index, shifting the
+ * equations from there up by one in every pane. It is shown in every pane.
+ *
+ * @param at int the index to move it to.
+ */
+void TGraph::moveLastEquation(int at) {
+  int last = ops.size() - 1;
+  if (at >= last)
+    return;
+  std::rotate(ops.begin() + at, ops.end() - 1, ops.end());
+  std::rotate(equations.begin() + at, equations.end() - 1, equations.end());
+  std::rotate(deps.begin() + at, deps.end() - 1, deps.end());
+  std::rotate(samples.begin() + at, samples.end() - 1, samples.end());
+  std::rotate(strides.begin() + at, strides.end() - 1, strides.end());
+  if ((int)shown.size() > at)
+    shown.insert(shown.begin() + at, 1);
+  for (size_t p = 0; p < panes.size(); p++) {
+    View& view = panes[p].view;
+    if ((int)p == focused)
+      continue;
+    if ((int)view.samples.size() > at) {
+      view.samples.insert(view.samples.begin() + at, std::vector<double>());
+      view.strides.insert(view.strides.begin() + at, 0);
+    }
+    if ((int)view.shown.size() > at)
+      view.shown.insert(view.shown.begin() + at, 1);
+  }
+  for (WatchedLine& entry : watched) {
+    if (entry.equation >= at)
+      entry.equation++;
+  }
+}
+
+/**
+ * @brief Sweeps a parameter from one value to another, presenting frames at a
+ * fixed rate. Only equations depending on the parameter are re-evaluated, and
+ * their x-only subexpressions are hoisted out of the frame loop into cached
+ * arrays first. Frames go out through the diff-based terminal writer, and
+ * frames are dropped when evaluation falls behind so the sweep keeps its
+ * duration.
+ *
+ * @param name const std::string& the parameter to animate.
+ * @param from double the first value of the parameter.
+ * @param to double the last value of the parameter.
+ * @param fps double the frame rate.
+ * @param seconds double the duration of the sweep.
+ */
+void TGraph::animate(const std::string& name,
+                     double from,
+                     double to,
+                     double fps,
+                     double seconds) {
+  int param = env.resolve(name);
+  if (param == -1 || env.get(param).kind != SymbolKind::PARAM) {
+    std::cout << "Not a defined parameter: " << name << "\n";
+    return;
+  }
+  if (fps <= 0 || seconds < 0) {
+    std::cout << "Invalid command syntax.\n";
+    return;
+  }
+  // frames are drawn over the cached points of the other equations
+  if (dirty) {
+    rerender();
+    if (dirty)
+      return;
+  }
+
+  // split the dependent equations and evaluate their hoisted parts once
+  std::vector<int> animated;
+  std::vector<std::vector<Operand>> residuals;
+  std::vector<std::vector<Operand>> hoisted;
+  for (size_t i = 0; i < equations.size(); i++) {
+    if (std::find(deps[i].begin(), deps[i].end(), name) == deps[i].end())
+      continue;
+    animated.push_back(i);
+    TG_TRACE("optimize", i);
+    residuals.push_back(optimizer.hoist(ops[i], param, hoisted));
+  }
+  cache.assign(hoisted.size(), std::vector<double>(sampleColumns()));
+  double xs[VM_BATCH];
+  for (size_t slot = 0; slot < hoisted.size(); slot++) {
+    for (int i = 0; i < sampleColumns(); i += VM_BATCH) {
+      int n = std::min(VM_BATCH, sampleColumns() - i);
+      for (int k = 0; k < n; k++) {
+        xs[k] = sampleX(i + k);
+      }
+      vm.runBatch(hoisted[slot], xs, n, &cache[slot][i], i);
+    }
+  }
+
+  int frames = std::max(1, (int)std::round(fps * seconds));
+  int shown = 0;
+  std::chrono::duration<double> period(1.0 / fps);
+  auto start = std::chrono::steady_clock::now();
+  writer.invalidate();
+  for (int f = 0; f <= frames;) {
+    double value = from + (to - from) * f / frames;
+    env.defineParam(name, value);
+    bool superseded = false;
+    for (size_t k = 0; k < animated.size() && !superseded; k++) {
+      superseded = !computePoints(animated[k], residuals[k]);
+    }
+    if (superseded) {
+      // a newer command stops the sweep
+      dirty = true;
+      break;
+    }
+
+    resetScreen();
+    for (size_t i = 0; i < ops.size(); i++) {
+      if (visible(this->shown, i))
+        plotPoints(i);
+    }
+    for (size_t i = 0; i < datasets.size(); i++) {
+      plotData(i);
+    }
+    writeToScreen(name + " = " + std::to_string(value), 1,
+                  5 + equations.size() + datasets.size());
+    compose();
+    writer.present(frame, std::cout, &frameColours);
+    shown++;
+    if (f == frames)
+      break;
+
+    // pace to the schedule, skipping frames that are already late
+    std::this_thread::sleep_until(
+        start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    period * (f + 1)));
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    f = std::min(frames, std::max(f + 1, (int)(elapsed / period)));
+  }
+  writer.finish(std::cout);
+  std::cout << shown << " frames shown, " << frames + 1 - shown
+            << " dropped.\n";
 }
 
 /**
- * @brief Sets up the window. Grabs the window size, initializes the screen, and
- * draws a blank graph.
+ * @brief Parses a streamed line holding either "y" or "t,y" (commas, spaces
+ * or tabs separate the values).
+ *
+ * @param line const char* the null terminated line.
+ * @param values double* receives up to two values.
+ * @return int the number of values parsed.
  */
-void TGraph::setupWindow() {
-// get the window size based on platform
-// windows
-#ifdef TG_WINDOWS
-  CONSOLE_SCREEN_BUFFER_INFO csbi;
-  GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi);
-  screenWidth = csbi.srWindow.Right - csbi.srWindow.Left + 1;
-  screenHeight = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
-#endif
-// macOS and Linux
+static int parseSample(const char* line, double* values) {
+  int count = 0;
+  char* end;
+  while (count < 2) {
+    while (*line == ' ' || *line == '\t' || *line == ',') {
+      line++;
+    }
+    double value = std::strtod(line, &end);
+    if (end == line)
+      break;
+    values[count++] = value;
+    line = end;
+  }
+  return count;
+}
+
+/**
+ * @brief Plots samples read from stdin as they arrive, one "y" or "t,y" per
+ * line, until the input ends. The most recent samples are kept in a ring
+ * buffer and the newest sample is pinned to the right edge once the samples
+ * span the width of the screen, samples whose t is before the newest one are
+ * dropped and counted. Frames are presented at STREAM_FPS, also while the
+ * input stalls (where stdin can be polled), only recomposing the columns
+ * whose samples changed unless the view scrolled, and the terminal writer
+ * then sends only the cells that differ. Equations are overlaid,
+ * re-evaluated only when the view scrolls.
+ */
+void TGraph::stream() {
+  RingBuffer<StreamSample> ring(STREAM_CAPACITY);
+  // rows covered by the samples of each column, low > high when empty
+  std::vector<int> low(screenWidth), high(screenWidth);
+  std::vector<int> shownLow(screenWidth, 0), shownHigh(screenWidth, -1);
+  std::vector<double> xs(screenWidth);
+  for (size_t e = 0; e < ops.size(); e++) {
+    strides[e] = VM::results(ops[e]);
+    samples[e].resize(screenWidth * strides[e]);
+  }
+  std::vector<char> input(STREAM_CHUNK + 1);
+  char* buffer = input.data();
+  size_t pending = 0;
+  double values[2];
+  size_t total = 0;
+  // samples older than the newest one, which the window cannot place
+  size_t dropped = 0;
+  size_t counted = 0;
+  double rate = 0;
+  double shownLeft = NAN;
+
+  frame.assign(screenHeight, std::u32string(screenWidth, U' '));
+  std::chrono::duration<double> period(1.0 / STREAM_FPS);
+  auto start = std::chrono::steady_clock::now();
+  auto next = start;
+  auto lastRate = start;
+  writer.invalidate();
+
+  // columns, rows and header are laid out once per frame, never per sample
+  auto present = [&]() {
+    double span = screenWidth * stepX;
+    double left = 0;
+    if (!ring.empty()) {
+      double newest = ring.recent(0).t;
+      double oldest = ring.recent(ring.size() - 1).t;
+      left = newest - oldest > span ? newest - span + stepX : oldest;
+      // snap to the grid so columns do not jitter as the view scrolls
+      left = std::floor(left / stepX) * stepX;
+    }
+    bool scrolled = left != shownLeft;
+    if (scrolled) {
+      shownLeft = left;
+      for (int i = 0; i < screenWidth; i++) {
+        xs[i] = left + i * stepX;
+      }
+      for (size_t e = 0; e < ops.size(); e++) {
+        for (int i = 0; i < screenWidth; i += VM_BATCH) {
+          int n = std::min(VM_BATCH, screenWidth - i);
+          vm.runBatch(ops[e], &xs[i], n, &samples[e][i * strides[e]], i);
+        }
+      }
+    }
+
+    std::fill(low.begin(), low.end(), screenHeight);
+    std::fill(high.begin(), high.end(), 0);
+    for (size_t age = 0; age < ring.size(); age++) {
+      const StreamSample& sample = ring.recent(age);
+      if (sample.t < left)
+        break;
+      if (std::isnan(sample.y))
+        continue;
+      int col = std::min(screenWidth - 1, (int)((sample.t - left) / stepX));
+      int r = plotRowClamped(sample.y, screenHeight, stepY);
+      low[col] = std::min(low[col], r);
+      high[col] = std::max(high[col], r);
+    }
+
+    int axisRow = screenHeight / 2;
+    for (int i = 0; i < screenWidth; i++) {
+      if (!scrolled && low[i] == shownLow[i] && high[i] == shownHigh[i])
+        continue;
+      shownLow[i] = low[i];
+      shownHigh[i] = high[i];
+      bool axisCol = xs[i] <= 0 && xs[i] + stepX > 0;
+      for (int j = 0; j < screenHeight; j++) {
+        char glyph = ' ';
+        if (j == axisRow)
+          glyph = axisCol ? '+' : '-';
+        else if (axisCol)
+          glyph = '|';
+        frame[j][i] = glyph;
+      }
+      for (size_t e = 0; e < ops.size(); e++) {
+        for (size_t k = 0; k < strides[e]; k++) {
+          int y = plotRow(samples[e][i * strides[e] + k], screenHeight, stepY);
+          if (y != -1)
+            frame[y][i] = plotSymbol(e);
+        }
+      }
+      for (int j = std::max(1, low[i]);
+           j <= std::min(screenHeight - 1, high[i]); j++) {
+        frame[j][i] = '*';
+      }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - lastRate;
+    if (elapsed.count() >= 1) {
+      rate = (total - counted) / elapsed.count();
+      counted = total;
+      lastRate = now;
+    }
+    std::string header[] = {
+        "TGraph v" + std::to_string(VERSION_MAJOR) + "." +
+            std::to_string(VERSION_MINOR),
+        "x-step: " + std::to_string(stepX),
+        "y-step: " + std::to_string(stepY),
+        "Streamed: " + std::to_string(total) + " (" +
+            std::to_string((long)rate) + "/s), dropped: " +
+            std::to_string(dropped)};
+    // header cells are restored by the next recompose of their columns
+    for (int row = 0; row < 4 && row + 1 < screenHeight; row++) {
+      std::string& text = header[row];
+      for (size_t i = 0; i < text.size() && (int)i + 1 < screenWidth; i++) {
+        frame[row + 1][i + 1] = text[i];
+      }
+      for (size_t i = 0; i <= text.size() + 8 && (int)i + 1 < screenWidth;
+           i++) {
+        shownHigh[i + 1] = -2;
+      }
+    }
+    for (size_t e = 0; e < ops.size() && (int)e + 5 < screenHeight; e++) {
+      std::string text = "f(x) = " + equations[e];
+      for (size_t i = 0; i < text.size() && (int)i + 1 < screenWidth; i++) {
+        frame[e + 5][i + 1] = text[i];
+      }
+    }
+    writer.present(frame, std::cout);
+  };
+
+  bool open = true;
+  while (open) {
 #ifdef TG_LINUX
-  struct winsize w;
-  ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
-  screenWidth = w.ws_col;
-  screenHeight = w.ws_row;
+    // frames keep their rate while the input stalls
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        next - std::chrono::steady_clock::now());
+    pollfd in{STDIN_FILENO, POLLIN, 0};
+    int ready = poll(&in, 1, std::max<long>(0, wait.count()));
+    if (ready == 0 || (ready < 0 && errno == EINTR)) {
+      auto now = std::chrono::steady_clock::now();
+      if (now >= next) {
+        present();
+        next =
+            now + std::chrono::duration_cast<std::chrono::nanoseconds>(period);
+      }
+      continue;
+    }
+    long got = read(STDIN_FILENO, buffer + pending, STREAM_CHUNK - pending);
+    if (got < 0 && errno == EINTR)
+      continue;
+#else
+    long got = std::fread(buffer + pending, 1, STREAM_CHUNK - pending, stdin);
 #endif
+    if (got <= 0) {
+      open = false;
+      // the input may end without a newline
+      if (pending > 0)
+        buffer[pending++] = '\n';
+    } else {
+      pending += got;
+    }
 
-  screen = std::vector(screenHeight, std::vector(screenWidth, ' '));
+    char* line = buffer;
+    char* end = buffer + pending;
+    char* newline;
+    while ((newline = (char*)std::memchr(line, '\n', end - line)) != nullptr) {
+      *newline = '\0';
+      int count = parseSample(line, values);
+      if (count == 1) {
+        ring.push({(double)total++, values[0]});
+      } else if (count == 2) {
+        // the window assumes t never goes backwards
+        if (std::isnan(values[0]) ||
+            (!ring.empty() && values[0] < ring.recent(0).t))
+          dropped++;
+        else
+          ring.push({values[0], values[1]});
+        total++;
+      }
+      line = newline + 1;
+    }
+    pending = end - line;
+    // keep the partial line, dropping it if it fills the whole buffer
+    if (pending == STREAM_CHUNK)
+      pending = 0;
+    std::memmove(buffer, line, pending);
 
-  stepX = 1.0;
-  stepY = 1.0;
-  ops.clear();
-  equations.clear();
+    auto now = std::chrono::steady_clock::now();
+    if (now >= next || !open) {
+      present();
+      next = now + std::chrono::duration_cast<std::chrono::nanoseconds>(period);
+    }
+  }
+  writer.finish(std::cout);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "Streamed " << total << " samples in " << elapsed.count()
+            << "s.\n";
+  if (dropped > 0) {
+    std::cout << "Dropped " << dropped
+              << " samples whose t was before the newest sample.\n";
+  }
+}
 
-  rerender();
+/**
+ * @brief Starts recording the commands of the session, each with the time it
+ * ran and the size of the terminal, for replaying with --replay.
+ *
+ * @param filename const std::string& the file to record to.
+ * @return bool true if the file could be opened.
+ */
+bool TGraph::record(const std::string& filename) {
+  recording.open(filename, std::ios::out | std::ios::trunc);
+  if (!recording)
+    return false;
+  recordStart = std::chrono::steady_clock::now();
+  recording << "# TGraph v" << VERSION_MAJOR << "." << VERSION_MINOR
+            << " session: milliseconds widthxheight command" << std::endl;
+  return true;
 }
 
 /**
- * @brief Helper for writing text to the screen 2d array.
+ * @brief Gets the name a replayed command is reported under: the command
+ * word, or "equation" for anything that is not a command.
  *
- * @param text std::string The text to write.
- * @param x int The x coordinate to write the text to.
- * @param y int The y coordinate to write the text to.
+ * @param command const std::string& the recorded command.
+ * @return std::string the name.
  */
-void TGraph::writeToScreen(std::string text, int x, int y) {
-  for (size_t i = 0; i < text.length(); i++) {
-    screen[y][x + i] = text[i];
-  }
+static std::string commandKind(const std::string& command) {
+  std::string word = command.substr(0, command.find(' '));
+  return isCommand(word) ? word : "equation";
 }
 
 /**
- * @brief CLI interface.
+ * @brief Gets a percentile of sorted latencies by the nearest rank.
+ *
+ * @param sorted const std::vector<double>& the latencies, in order.
+ * @param p double the percentile, 0 to 100.
+ * @return double the latency.
  */
-void TGraph::cli() {
-  std::string command{""};
-  do {
-    std::cout << "Equation or command > (f(x) = ) ";
-    std::getline(std::cin, command);
-    parseInput(command);
-  } while (command.length() > 0);
+static double percentile(const std::vector<double>& sorted, double p) {
+  size_t rank = (size_t)std::ceil(p / 100 * sorted.size());
+  return sorted[std::max<size_t>(rank, 1) - 1];
 }
 
 /**
- * @brief Compute the points of a specified equation.
+ * @brief Replays a session recorded with --record without a terminal. Each
+ * command runs at the terminal size it was recorded at (a change of size is
+ * replayed as a resize), at the recorded pace divided by speed or back to
+ * back when speed is 0, and is timed from start to finished frame. Prints
+ * the p50 and p99 latency of all commands and of each kind of command, and
+ * the throughput. Commands that write files or watch one (save, render,
+ * export and watch) are skipped, so replaying a session does not overwrite
+ * files in the current directory.
  *
- * @param equation int The index of the equation to compute.
+ * @param filename const std::string& the recorded session.
+ * @param speed double how many times faster than recorded to replay, 0 for
+ * as fast as possible.
+ * @return int exit code for the program.
  */
-void TGraph::computePoints(int equation) {
-  char symbol = 'a' + (23 + equation) % 26;
-  for (int i = 0; i < screenWidth; i++) {
-    // corrected x for matrix
-    double x = (i - screenWidth / 2) * stepX;
-    for (double& yv : simulateEquation(x, equation)) {
-      // corrected y for matrix
-      int y = round(screenHeight / 2 - yv / stepY);
-      if (y > 0 && y < screenHeight) {
-        screen[y][i] = symbol;
-      }
+int TGraph::replay(const std::string& filename, double speed) {
+  std::ifstream in(filename);
+  if (!in) {
+    std::cout << "Could not open session file: " << filename << "\n";
+    return 1;
+  }
+  struct Entry {
+    double at;
+    int width;
+    int height;
+    std::string command;
+  };
+  std::vector<Entry> entries;
+  std::string line;
+  for (int number = 1; std::getline(in, line); number++) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    Entry entry;
+    char by;
+    if (!(fields >> entry.at >> entry.width >> by >> entry.height) ||
+        by != 'x' || entry.width <= 0 || entry.height <= 0) {
+      std::cout << "Invalid session line " << number << ".\n";
+      return 1;
+    }
+    std::getline(fields, entry.command);
+    entry.command = trim(entry.command);
+    // the session ended here
+    if (entry.command == "exit")
+      break;
+    entries.push_back(entry);
+  }
+  if (entries.empty()) {
+    std::cout << "No commands in session file: " << filename << "\n";
+    return 1;
+  }
+
+  // start from a blank graph at the size of the first command
+  resize(entries[0].width, entries[0].height);
+  rerender();
+  std::vector<std::string> kinds;
+  std::vector<std::vector<double>> latencies;
+  std::vector<double> all;
+  auto time = [&](const std::string& kind, auto run) {
+    auto began = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::milli> took =
+        std::chrono::steady_clock::now() - began;
+    size_t k = std::find(kinds.begin(), kinds.end(), kind) - kinds.begin();
+    if (k == kinds.size()) {
+      kinds.push_back(kind);
+      latencies.emplace_back();
+    }
+    latencies[k].push_back(took.count());
+    all.push_back(took.count());
+  };
+  // messages and errors of the commands are not shown either
+  std::streambuf* shown = std::cout.rdbuf(nullptr);
+  std::streambuf* errors = std::cerr.rdbuf(nullptr);
+  size_t skipped = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const Entry& entry : entries) {
+    if (speed > 0) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::duration<double, std::milli>(entry.at /
+                                                                speed)));
+    }
+    if (entry.width != terminalWidth || entry.height != terminalHeight) {
+      time("resize", [&] {
+        resize(entry.width, entry.height);
+        writer.invalidate();
+        rerender();
+      });
     }
+    // replaying must not overwrite files or start watching one
+    std::string kind = commandKind(entry.command);
+    if (kind == "save" || kind == "render" || kind == "export" ||
+        kind == "watch") {
+      skipped++;
+      continue;
+    }
+    time(kind, [&] { parseInput(entry.command); });
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout.rdbuf(shown);
+  std::cout.clear();
+  std::cerr.rdbuf(errors);
+  std::cerr.clear();
+
+  double busy = std::accumulate(all.begin(), all.end(), 0.0) / 1000;
+  size_t replayed = entries.size() - skipped;
+  std::cout << "Replayed " << replayed << " commands in " << elapsed.count()
+            << "s (" << busy << "s running them, "
+            << (busy > 0 ? replayed / busy : 0) << " commands/s).\n";
+  if (skipped > 0) {
+    std::cout << "Skipped " << skipped
+              << " save, render, export and watch commands, which would "
+                 "write or watch files.\n";
+  }
+  if (all.empty())
+    return 0;
+  char row[128];
+  snprintf(row, sizeof(row), "%-12s %8s %10s %10s %10s\n", "command", "count",
+           "p50 ms", "p99 ms", "max ms");
+  std::cout << row;
+  kinds.insert(kinds.begin(), "all");
+  latencies.insert(latencies.begin(), all);
+  for (size_t k = 0; k < kinds.size(); k++) {
+    std::vector<double>& sorted = latencies[k];
+    std::sort(sorted.begin(), sorted.end());
+    snprintf(row, sizeof(row), "%-12.12s %8zu %10.3f %10.3f %10.3f\n",
+             kinds[k].c_str(), sorted.size(), percentile(sorted, 50),
+             percentile(sorted, 99), sorted.back());
+    std::cout << row;
   }
-  writeToScreen("f(x) = " + equations[equation], 1, 5 + equation);
+  return 0;
 }
 
 /**
- * @brief Draws the graph to the screen.
+ * @brief Gets the program of an equation number (1 based) or compiles an
+ * expression, printing an error if neither works.
+ *
+ * @param target const std::string& the equation number or expression.
+ * @param program std::vector<Operand>& receives the program.
+ * @return bool true if a program was found.
  */
-void TGraph::draw(std::ostream& stream) {
-  stream << std::endl;
-  for (int j = 0; j < screenHeight; j++) {
-    for (int i = 0; i < screenWidth; i++) {
-      if (screen[j][i] != ' ') {
-        stream << screen[j][i];
-      } else {
-        int x = i - screenWidth / 2;
-        int y = screenHeight / 2 - j;
-        if (x == 0 && y == 0)
-          stream << "+";
-        else if (x == -1 && y == -1)
-          stream << "O";
-        else if (x == 0)
-          stream << "|";
-        else if (y == 0)
-          stream << "-";
-        else
-          stream << " ";
-      }
+bool TGraph::resolveProgram(const std::string& target,
+                            std::vector<Operand>& program) {
+  if (target.find_first_not_of("0123456789") == std::string::npos) {
+    size_t equation = std::stoul(target);
+    if (equation < 1 || equation > equations.size()) {
+      std::cout << "No such equation.\n";
+      return false;
     }
-    stream << "\n";
+    program = ops[equation - 1];
+    return true;
+  }
+  std::vector<Token> expr = scanner.scan(target);
+  if (scanner.hadError() || expr.empty()) {
+    std::cout << "Invalid expression.\n";
+    return false;
   }
+  program = parser.parse(expr);
+  if (parser.hadError()) {
+    std::cout << "Invalid expression.\n";
+    return false;
+  }
+  program = optimizer.polynomials(program);
+  return true;
 }
 
 /**
- * @brief Re-renders the 2d screen array (for when zooming happens, etc.)
+ * @brief Profiles a program over the columns of the current view, repeating
+ * it for at least PROFILE_MS. Prints the time per x, the max stack depth and
+ * the listing of the program annotated with how often each instruction ran
+ * and its share of the cycles, followed by totals per opcode and per builtin
+ * function.
+ *
+ * @param target const std::string& the equation number or expression.
  */
-void TGraph::rerender() {
-#ifdef TG_WINDOWS
-  system("cls");
-#endif
-#ifdef TG_LINUX
-  system("clear");
+void TGraph::profile(const std::string& target) {
+  std::vector<Operand> program;
+  if (!resolveProgram(target, program))
+    return;
+  VMProfile stats;
+  VM profiler(&env);
+  profiler.setProfile(&stats);
+  std::vector<double> out(VM_BATCH * std::max<size_t>(1, VM::results(program)));
+  double xs[VM_BATCH];
+  int runs = 0;
+  std::chrono::duration<double, std::milli> elapsed{0};
+  auto start = std::chrono::steady_clock::now();
+  while (elapsed.count() < PROFILE_MS && runs < PROFILE_MAX_RUNS) {
+    for (int i = 0; i < screenWidth; i += VM_BATCH) {
+      int n = std::min(VM_BATCH, screenWidth - i);
+      for (int k = 0; k < n; k++) {
+        xs[k] = plotX(i + k, screenWidth, stepX, originX);
+      }
+      profiler.runBatch(program, xs, n, out.data());
+    }
+    runs++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  }
+
+#ifdef TG_RDTSC
+  const char* unit = "cycles";
+#else
+  const char* unit = "ns";
 #endif
-  screen = std::vector(screenHeight, std::vector(screenWidth, ' '));
+  uint64_t total = 0;
+  for (uint64_t cycles : stats.cycles) {
+    total += cycles;
+  }
+  char line[128];
+  snprintf(line, sizeof(line),
+           "%d runs over %d columns, %.2f ns per x, max stack depth %zu\n",
+           runs, screenWidth, elapsed.count() * 1e6 / runs / screenWidth,
+           stats.maxDepth);
+  std::cout << line;
+  snprintf(line, sizeof(line), "%12s %14s %6s  %s\n", "count", unit, "%",
+           "instruction");
+  std::cout << line;
 
-  writeToScreen("TGraph v" + std::to_string(VERSION_MAJOR) + "." +
-                    std::to_string(VERSION_MINOR),
-                1, 1);
-  writeToScreen("x-step: " + std::to_string(stepX), 1, 2);
-  writeToScreen("y-step: " + std::to_string(stepY), 1, 3);
-  writeToScreen("Equations:", 1, 4);
+  // totals per opcode (builtins have their own) in order of appearance
+  std::vector<std::string> names;
+  std::vector<uint64_t> counts;
+  std::vector<uint64_t> cycles;
+  for (size_t i = 0; i < program.size();) {
+    std::ostringstream listing;
+    size_t next = parser.printOP(program, i, listing);
+    std::string text = listing.str();
+    if (!text.empty() && text.back() == '\n')
+      text.pop_back();
+    snprintf(line, sizeof(line), "%12llu %14llu %5.1f%%  ",
+             (unsigned long long)stats.counts[i],
+             (unsigned long long)stats.cycles[i],
+             total ? 100.0 * stats.cycles[i] / total : 0.0);
+    std::cout << line << text << "\n";
 
-  for (size_t i = 0; i < ops.size(); i++) {
-    computePoints(i);
+    std::string name = text.substr(0, text.find(' '));
+    size_t k = std::find(names.begin(), names.end(), name) - names.begin();
+    if (k == names.size()) {
+      names.push_back(name);
+      counts.push_back(0);
+      cycles.push_back(0);
+    }
+    counts[k] += stats.counts[i];
+    cycles[k] += stats.cycles[i];
+    i = next;
+  }
+  std::cout << "\nBy opcode:\n";
+  for (size_t k = 0; k < names.size(); k++) {
+    snprintf(line, sizeof(line), "%12llu %14llu %5.1f%%  ",
+             (unsigned long long)counts[k], (unsigned long long)cycles[k],
+             total ? 100.0 * cycles[k] / total : 0.0);
+    std::cout << line << names[k] << "\n";
   }
-
-  draw(std::cout);
 }
 
 /**
- * @brief Parses an equation string and adds it to the list of equations.
- *
- * @param equation std::string The equation to add.
+ * @brief Shows the memory held by the compiled programs, the caches and the
+ * framebuffers, and with allocation tracking compiled in, the allocations
+ * made by each phase of the last frame against the frame budget.
  */
-void TGraph::parseEquation(std::string& equation) {
-  std::vector<Token> tokens = scanner.scan(equation);
-  ops.push_back(parser.parse(tokens));
-  equations.push_back(equation);
-#ifdef TG_DEBUG
-  parser.printOPs(ops);
+void TGraph::memory() {
+  settle();
+  size_t programs = ops.capacity() * sizeof(std::vector<Operand>);
+  for (size_t i = 0; i < ops.size(); i++) {
+    programs += ops[i].capacity() * sizeof(Operand) + equations[i].capacity();
+  }
+  size_t caches = 0;
+  for (const std::vector<double>& ys : samples) {
+    caches += ys.capacity() * sizeof(double);
+  }
+  for (const Pane& pane : panes) {
+    for (const std::vector<double>& ys : pane.view.samples) {
+      caches += ys.capacity() * sizeof(double);
+    }
+  }
+  size_t hoisted = 0;
+  for (const std::vector<double>& values : cache) {
+    hoisted += values.capacity() * sizeof(double);
+  }
+  size_t data = 0;
+  size_t mapped = 0;
+  for (size_t d = 0; d < datasets.size(); d++) {
+    data += datasets[d]->footprint() +
+            (dataLows[d].capacity() + dataHighs[d].capacity()) * sizeof(double);
+    mapped += datasets[d]->size() * 2 * sizeof(double);
+  }
+  size_t screens = 0;
+  for (const std::vector<char>& row : screen) {
+    screens += row.capacity();
+  }
+  for (const std::u32string& row : frame) {
+    screens += row.capacity() * sizeof(char32_t);
+  }
+  for (const ColourRow& row : frameColours) {
+    screens += row.capacity();
+  }
+  screens += dots.capacity() + colours.capacity() + shades.capacity() +
+             output.capacity();
+  screens += writer.footprint();
+
+  char line[128];
+  auto show = [&](const char* name, size_t bytes) {
+    snprintf(line, sizeof(line), "%-22s %12.1f KiB\n", name, bytes / 1024.0);
+    std::cout << line;
+  };
+  show("programs", programs);
+  show("sample caches", caches);
+  show("hoisted caches", hoisted);
+  size_t grids = 0;
+  for (const std::unique_ptr<Field>& field : fields) {
+    grids += field->footprint();
+  }
+  show("dataset pyramids", data);
+  show("fields", grids);
+  size_t curveSamples = 0;
+  for (const std::unique_ptr<Curve>& curve : curves) {
+    curveSamples += curve->footprint();
+  }
+  show("curves", curveSamples);
+  show("datasets (mapped)", mapped);
+  show("framebuffers", screens);
+  show("vm stack", vm.footprint());
+#ifdef TG_LINUX
+  // the second field of statm is the resident set in pages
+  long pages = 0;
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (statm != nullptr) {
+    if (fscanf(statm, "%*d %ld", &pages) != 1)
+      pages = 0;
+    fclose(statm);
+  }
+  if (pages > 0)
+    show("process resident", (size_t)pages * sysconf(_SC_PAGESIZE));
 #endif
+
+  if (!allocTracking()) {
+    std::cout << "Allocation tracking is off, define TG_ALLOC_TRACK to count "
+                 "allocations per frame.\n";
+    return;
+  }
+  AllocCount total = totalAllocations();
+  snprintf(line, sizeof(line), "\n%llu allocations (%.1f KiB), %llu live\n",
+           (unsigned long long)total.allocations, total.bytes / 1024.0,
+           (unsigned long long)liveAllocations());
+  std::cout << line;
+  std::cout << "Last frame:\n";
+  auto phase = [&](const char* name, const AllocCount& count) {
+    snprintf(line, sizeof(line), "%-22s %8llu allocations %12llu bytes\n",
+             name, (unsigned long long)count.allocations,
+             (unsigned long long)count.bytes);
+    std::cout << line;
+  };
+  phase("  compute", frameAllocs.compute);
+  phase("  plot", frameAllocs.plot);
+  phase("  draw", frameAllocs.draw);
+  snprintf(line, sizeof(line),
+           "%llu of %llu frames over the budget of %d allocations\n",
+           (unsigned long long)frameAllocs.overBudget,
+           (unsigned long long)frameAllocs.frames, ALLOC_FRAME_BUDGET);
+  std::cout << line;
 }
 
 /**
@@ -169,112 +2963,11 @@ void TGraph::parseEquation(std::string& equation) {
  *
  * @param x double The x value to simulate the equation with.
  * @param equation int the index of the equation to simulate.
- * @return double The y value of the equation at x.
- */
-std::vector<double> TGraph::simulateEquation(double x, int equation) {
-#undef CONST
-  std::stack<double> nums;
-  int start = 0;
-  std::vector<Operand>& eqOps = ops[equation];
-  for (size_t i = 0; i < eqOps.size(); i++) {
-    start = i;
-    switch (eqOps[i].opcode) {
-      case OP::CONST: {
-        nums.push(eqOps[++i].value);
-        break;
-      }
-      case OP::VAR: {
-        nums.push(x);
-        break;
-      }
-      case OP::NEG: {
-        double num = nums.top();
-        nums.pop();
-        nums.push(-num);
-        break;
-      }
-      case OP::ADD: {
-        double a = nums.top();
-        nums.pop();
-        double b = nums.top();
-        nums.pop();
-        nums.push(a + b);
-        break;
-      }
-      case OP::SUB: {
-        double a = nums.top();
-        nums.pop();
-        double b = nums.top();
-        nums.pop();
-        nums.push(b - a);
-        break;
-      }
-      case OP::MUL: {
-        double a = nums.top();
-        nums.pop();
-        double b = nums.top();
-        nums.pop();
-        nums.push(a * b);
-        break;
-      }
-      case OP::DIV: {
-        double a = nums.top();
-        nums.pop();
-        double b = nums.top();
-        nums.pop();
-        if (a == 0)
-          nums.push(INT_MIN);
-        else
-          nums.push(b / a);
-        break;
-      }
-      case OP::POW: {
-        double a = nums.top();
-        nums.pop();
-        double b = nums.top();
-        nums.pop();
-        nums.push(std::pow(b, a));
-        break;
-      }
-      case OP::PLUS_OR_MINUS: {
-        double num = nums.top();
-        nums.push(-num);
-        break;
-      }
-      case OP::MAGIC: {
-        double a = nums.top();
-        nums.pop();
-        if (a > 0) {
-          nums.push(INT_MAX);
-        } else {
-          // INTEGRAL(e^-a^2t) = -1/a^2
-          nums.push(1 / std::pow(a, 2));
-        }
-        break;
-      }
-      case OP::BUILTIN: {
-        double a = nums.top();
-        nums.pop();
-        nums.push((*eqOps[++i].fnptr)(a));
-        break;
-      }
-    }
-#ifdef TG_DEBUG
-    parser.printOP(ops, start);
-    std::vector<double> temp;
-    while (!nums.empty()) {
-      temp.push_back(nums.top());
-      nums.pop();
-    }
-    for (int i = temp.size() - 1; i >= 0; i--) {
-      std::cout << "[" << temp[i] << "]";
-      nums.push(temp[i]);
-    }
-    std::cout << "\n";
-#endif
-  }
-  return std::vector<double>(&nums.top() + 1 - nums.size(), &nums.top() + 1);
-#define CONST const
+ * @param out double* receives the y values of the equation at x.
+ * @return size_t the number of y values.
+ */
+size_t TGraph::simulateEquation(double x, int equation, double* out) {
+  return vm.runBatch(ops[equation], &x, 1, out);
 }
 
 /**
@@ -301,13 +2994,26 @@ void TGraph::parseInput(std::string input) {
   }
   if (tokens.size() == 0)
     return;
+  if (recording.is_open()) {
+    std::chrono::duration<double, std::milli> at =
+        std::chrono::steady_clock::now() - recordStart;
+    char stamp[64];
+    snprintf(stamp, sizeof(stamp), "%.3f %dx%d ", at.count(), terminalWidth,
+             terminalHeight);
+    // flushed now, exit does not close the file
+    recording << stamp << input << std::endl;
+  }
+  // traced under the command name, or the equation for anything else
+  TG_TRACE(tokens[0].c_str());
   if (tokens[0].compare("help") == 0) {
+    if (!headless) {
 #ifdef TG_WINDOWS
-    system("cls");
+      system("cls");
 #endif
 #ifdef TG_LINUX
-    system("clear");
+      system("clear");
 #endif
+    }
     std::cout << "TGraph v" << VERSION_MAJOR << "." << VERSION_MINOR
               << " by Devin Arena:\n";
     std::cout << "help - displays this help message menu\n";
@@ -315,8 +3021,43 @@ void TGraph::parseInput(std::string input) {
     std::cout << "clear - clears all equations\n";
     std::cout << "exit - exits the program\n";
     std::cout << "save [file] - save the current output to a file\n";
+    std::cout << "export [eq] [x0] [x1] [n] [file] [csv|f64] - export n "
+                 "samples of an equation number or expression\n";
+    std::cout << "profile [eq] - profiles the opcodes of an equation number "
+                 "or expression\n";
+    std::cout << "memory - shows memory use and allocations per frame\n";
+    std::cout << "render [file.pgm|file.ppm] [width] [height] - renders the "
+                 "equations of the focused pane to an image (not fields, "
+                 "curves or data)\n";
+    std::cout << "load [file] - plots x,y pairs from a CSV or raw float64 "
+                 "(.f64) file\n";
+    std::cout << "watch [file|off] - runs a file of equations and commands, "
+                 "rerunning the changed lines when it is saved (removed "
+                 "commands other than plots and load are not undone)\n";
+    std::cout << "left/right/up/down [n] - pans the view by n columns or "
+                 "rows\n";
+    std::cout << "center [x] [y] - centers the view on a point\n";
+    std::cout << "mode [ascii|halfblock|braille] - draws curves with letters "
+                 "or with 1x2 or 2x4 dots per cell\n";
+    std::cout << "colour [off|16|256|truecolor] - colours each curve\n";
+    std::cout << "implicit [expr or lhs = rhs] - draws where an expression "
+                 "of x and y is zero\n";
+    std::cout << "heat [expr] - shades the view by an expression of x and "
+                 "y\n";
+    std::cout << "param x(t) = [expr], y(t) = [expr] [t0] [t1] - draws a "
+                 "parametric curve\n";
+    std::cout << "polar r(theta) = [expr] [theta0 theta1] - draws a polar "
+                 "curve, theta from 0 to 2pi by default\n";
+    std::cout << "split [h|v] - splits the active pane side by side or one "
+                 "above the other, each pane has its own view\n";
+    std::cout << "pane [n] [all|eq...] - lists the panes, makes pane n active "
+                 "and chooses the equations it shows\n";
     std::cout << "xstep [step_size, default=1] - sets the x step size\n";
     std::cout << "ystep [step_size, default=1] - sets the y step size\n";
+    std::cout << "let [a = value] - defines a parameter, lists definitions\n";
+    std::cout << "let [g(t) = expression] - defines a function of t\n";
+    std::cout << "animate a from [v0] to [v1] [fps n] [seconds s] - sweeps a "
+                 "parameter\n";
     std::cout << "'+' - zoom in (xstep /= 2, ystep /= 2)\n";
     std::cout << "'-' - zoom out (xstep *= 2, ystep *= 2)\n";
     std::cout << "Simply enter an equation to graph it.\n";
@@ -324,9 +3065,218 @@ void TGraph::parseInput(std::string input) {
     std::cout << "f(x) = x^2\n";
     std::cout << "f(x) = sin(x)\n";
     std::cout << "f(x) = x*cos(x / 5)\n";
-    std::cout << "f(x) = e ^ sqrt(x)\n\n";
+    std::cout << "f(x) = e ^ sqrt(x)\n";
+    std::cout << "f(x) = x < 0 ? -x : clamp(x^2, 0, 5)\n";
+    std::cout << "f(x) = atan2(sinh(x), floor(x)) + log10(exp(x))\n";
+    std::cout << "implicit x^2 + y^2 = 25\n";
+    std::cout << "polar r(theta) = 5 * cos(3 * theta)\n\n";
+  } else if (tokens[0].compare("let") == 0) {
+    if (tokens.size() == 1) {
+      for (size_t i = 0; i < env.size(); i++) {
+        const Symbol& symbol = env.get(i);
+        if (symbol.kind == SymbolKind::PARAM)
+          std::cout << symbol.name << " = " << symbol.value << "\n";
+        else
+          std::cout << symbol.name << "(" << symbol.arg
+                    << ") = " << symbol.body << "\n";
+      }
+      return;
+    }
+    define(input.substr(input.find("let") + 3));
+  } else if (tokens[0].compare("animate") == 0) {
+    // animate a from 0 to 10 [fps 30] [seconds 3]
+    if (tokens.size() < 6 || tokens.size() % 2 != 0 ||
+        tokens[2].compare("from") != 0 || tokens[4].compare("to") != 0) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    double fps = 30;
+    double seconds = 3;
+    for (size_t i = 6; i < tokens.size(); i += 2) {
+      if (tokens[i].compare("fps") == 0) {
+        fps = std::stod(tokens[i + 1]);
+      } else if (tokens[i].compare("seconds") == 0) {
+        seconds = std::stod(tokens[i + 1]);
+      } else {
+        std::cout << "Invalid command syntax.\n";
+        return;
+      }
+    }
+    animate(tokens[1], std::stod(tokens[3]), std::stod(tokens[5]), fps,
+            seconds);
+  } else if (tokens[0].compare("export") == 0) {
+    // export <eq> <x0> <x1> <n> <file> [csv|f64]
+    if (tokens.size() != 6 && tokens.size() != 7) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    std::vector<Operand> program;
+    if (!resolveProgram(tokens[1], program))
+      return;
+    std::string format = tokens.size() == 7 ? tokens[6] : "csv";
+    size_t n = std::stoull(tokens[4]);
+    Exporter exporter(vm);
+    auto start = std::chrono::steady_clock::now();
+    bool ok;
+    if (format.compare("csv") == 0) {
+      ok = exporter.writeCSV(program, std::stod(tokens[2]),
+                             std::stod(tokens[3]), n, tokens[5]);
+    } else if (format.compare("f64") == 0) {
+      ok = exporter.writeF64(program, std::stod(tokens[2]),
+                             std::stod(tokens[3]), n, tokens[5]);
+    } else {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    if (!ok) {
+      std::cout << "Error writing file.\n";
+      return;
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "Exported " << n << " samples in " << elapsed.count()
+              << "s.\n";
+  } else if (tokens[0].compare("profile") == 0) {
+    if (tokens.size() < 2) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    profile(trim(input.substr(input.find("profile") + 7)));
+  } else if (tokens[0].compare("mode") == 0) {
+    if (tokens.size() != 2) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    setMode(tokens[1]);
+  } else if (tokens[0].compare("colour") == 0 ||
+             tokens[0].compare("color") == 0) {
+    if (tokens.size() != 2) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    setColours(tokens[1]);
+  } else if (tokens[0].compare("implicit") == 0 ||
+             tokens[0].compare("heat") == 0) {
+    // implicit <expr> or <lhs> = <rhs>, heat <expr>
+    if (tokens.size() < 2) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    bool heat = tokens[0].compare("heat") == 0;
+    addField(heat ? FieldKind::HEAT : FieldKind::IMPLICIT,
+             trim(input.substr(input.find(tokens[0]) + tokens[0].size())));
+  } else if (tokens[0].compare("param") == 0 ||
+             tokens[0].compare("polar") == 0) {
+    // param x(t) = <expr>, y(t) = <expr> <t0> <t1>
+    // polar r(theta) = <expr> [theta0 theta1]
+    if (tokens.size() < 2) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    bool polar = tokens[0].compare("polar") == 0;
+    addCurve(polar ? CurveKind::POLAR : CurveKind::PARAMETRIC,
+             trim(input.substr(input.find(tokens[0]) + tokens[0].size())));
+  } else if (tokens[0].compare("split") == 0) {
+    if (tokens.size() != 2 ||
+        (tokens[1].compare("h") != 0 && tokens[1].compare("v") != 0)) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    split(tokens[1].compare("h") == 0);
+  } else if (tokens[0].compare("pane") == 0) {
+    selectPane(tokens);
+  } else if (tokens[0].compare("memory") == 0) {
+    memory();
+  } else if (tokens[0].compare("render") == 0) {
+    // render <file.pgm|file.ppm> <width> <height>
+    if (tokens.size() != 4) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    std::string filename = tokens[1];
+    std::string extension =
+        filename.size() > 4 ? filename.substr(filename.size() - 4) : "";
+    if (extension.compare(".pgm") != 0 && extension.compare(".ppm") != 0) {
+      std::cout << "Image must be a .pgm or .ppm file.\n";
+      return;
+    }
+    int width = std::stoi(tokens[2]);
+    int height = std::stoi(tokens[3]);
+    if (width <= 0 || height <= 0) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    // cover the same window as the terminal, each cell centred on its x/y
+    double left = originX + (-(screenWidth / 2) - 0.5) * stepX;
+    double top = originY + (screenHeight / 2 + 0.5) * stepY;
+    // the equations the focused pane shows, in their terminal colours
+    std::vector<std::vector<Operand>> programs;
+    std::vector<int> palette;
+    for (size_t i = 0; i < ops.size(); i++) {
+      if (visible(shown, i)) {
+        programs.push_back(ops[i]);
+        palette.push_back(i);
+      }
+    }
+    Rasterizer rasterizer(&env, programs, palette, left,
+                          left + screenWidth * stepX,
+                          top - screenHeight * stepY, top);
+    auto start = std::chrono::steady_clock::now();
+    if (!rasterizer.render(filename, width, height,
+                           extension.compare(".ppm") == 0)) {
+      std::cout << "Error writing file.\n";
+      return;
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "Rendered " << width << "x" << height << " image in "
+              << elapsed.count() << "s.\n";
+  } else if (tokens[0].compare("load") == 0) {
+    if (tokens.size() != 2) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    load(tokens[1]);
+  } else if (tokens[0].compare("left") == 0 ||
+             tokens[0].compare("right") == 0 ||
+             tokens[0].compare("up") == 0 || tokens[0].compare("down") == 0) {
+    // left/right/up/down [n], a quarter of the screen by default
+    if (tokens.size() > 2) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    bool horizontal =
+        tokens[0].compare("left") == 0 || tokens[0].compare("right") == 0;
+    int n = tokens.size() == 2 ? std::stoi(tokens[1])
+                               : (horizontal ? screenWidth : screenHeight) / 4;
+    if (tokens[0].compare("left") == 0 || tokens[0].compare("down") == 0)
+      n = -n;
+    if (horizontal)
+      pan(n, 0);
+    else
+      pan(0, n);
+  } else if (tokens[0].compare("center") == 0) {
+    if (tokens.size() != 3) {
+      std::cout << "Invalid command syntax.\n";
+      return;
+    }
+    originX = std::stod(tokens[1]);
+    originY = std::stod(tokens[2]);
+    rerender();
   } else if (tokens[0].compare("graph") == 0) {
     rerender();
+  } else if (tokens[0].compare("watch") == 0) {
+    if (tokens.size() == 1) {
+      if (watcher.isOpen())
+        std::cout << "Watching " << watcher.getPath() << ".\n";
+      else
+        std::cout << "Not watching a file.\n";
+    } else if (tokens.size() == 2 && tokens[1] == "off") {
+      watcher.close();
+      watched.clear();
+    } else {
+      watch(trim(input.substr(input.find("watch") + 5)));
+    }
   } else if (tokens[0].compare("clear") == 0) {
     setupWindow();
   } else if (tokens[0].compare("exit") == 0) {
@@ -363,6 +3313,7 @@ void TGraph::parseInput(std::string input) {
       std::cout << "Invalid command syntax.\n";
       return;
     }
+    settle();
     std::string filename = tokens[1];
     std::ofstream outfile;
     outfile.open(filename);
@@ -373,15 +3324,16 @@ void TGraph::parseInput(std::string input) {
     draw(outfile);
     outfile.close();
   } else {
-    parseEquation(input);
-    computePoints(ops.size() - 1);
-#ifdef TG_WINDOWS
-    system("cls");
-#endif
-#ifdef TG_LINUX
-    system("clear");
-#endif
-    draw(std::cout);
+    if (!parseEquation(input)) {
+      std::cout << "Invalid equation.\n";
+      return;
+    }
+    if (!computeEquations({(int)ops.size() - 1})) {
+      dirty = true;
+      return;
+    }
+    // redrawn from the caches so dataset labels move below the new equation
+    redraw();
   }
 }
 
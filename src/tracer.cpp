@@ -0,0 +1,178 @@
+/**
+ * @file tracer.cpp
+ * @author Devin Arena
+ * @brief Implementation file for the trace event recorder.
+ * @since 10/19/2026
+ **/
+
+#include "../include/tracer.hpp"
+
+#include <stdio.h>
+#include <cstdlib>
+
+/**
+ * @brief Default constructor, tracing starts disabled.
+ */
+Tracer::Tracer() : active(false), frame(0), threads(0) {}
+
+/**
+ * @brief Gets the process wide tracer.
+ *
+ * @return Tracer& the tracer.
+ */
+Tracer& Tracer::instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+/**
+ * @brief Starts recording events, to be written to a file when the program
+ * exits (or on flush).
+ *
+ * @param path const std::string& the JSON file to write.
+ * @return bool false if the file cannot be created.
+ */
+bool Tracer::open(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "w");
+  if (file == nullptr)
+    return false;
+  fclose(file);
+  this->path = path;
+  origin = std::chrono::steady_clock::now();
+  events.reserve(1 << 16);
+  if (!active.exchange(true))
+    std::atexit(flushAtExit);
+  nameThread("main");
+  return true;
+}
+
+/**
+ * @brief Writes the trace when the program exits, however it exits.
+ */
+void Tracer::flushAtExit() {
+  instance().flush();
+}
+
+/**
+ * @brief Gets the time since tracing started.
+ *
+ * @return uint64_t the time in microseconds.
+ */
+uint64_t Tracer::now() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - origin)
+      .count();
+}
+
+/**
+ * @brief Gets the id of the calling thread in the trace, numbering threads in
+ * the order they first record an event.
+ *
+ * @return int the thread id.
+ */
+int Tracer::threadId() {
+  thread_local int id = ++threads;
+  return id;
+}
+
+/**
+ * @brief Names the calling thread in the trace viewer.
+ *
+ * @param name const std::string& the name of the thread.
+ */
+void Tracer::nameThread(const std::string& name) {
+  if (!enabled())
+    return;
+  std::lock_guard<std::mutex> lock(mutex);
+  events.push_back({name, 'M', threadId(), 0, 0, 0, -1, {}});
+}
+
+/**
+ * @brief Records a complete event on the calling thread.
+ *
+ * @param name const std::string& the name of the event.
+ * @param start uint64_t when the event started, from now().
+ * @param duration uint64_t how long the event took in microseconds.
+ * @param value long a value to show with the event, -1 for none.
+ * @param allocated const AllocCount& the allocations made during the event.
+ */
+void Tracer::record(const std::string& name,
+                    uint64_t start,
+                    uint64_t duration,
+                    long value,
+                    const AllocCount& allocated) {
+  int tid = threadId();
+  uint64_t current = frame.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(mutex);
+  events.push_back(
+      {name, 'X', tid, start, duration, current, value, allocated});
+}
+
+/**
+ * @brief Marks the current frame as presented, events recorded after it belong
+ * to the next frame.
+ */
+void Tracer::nextFrame() {
+  if (!enabled())
+    return;
+  uint64_t current = frame++;
+  int tid = threadId();
+  std::lock_guard<std::mutex> lock(mutex);
+  events.push_back({"frame", 'i', tid, now(), 0, current, -1, {}});
+}
+
+/**
+ * @brief Writes the events recorded so far in the Chrome trace event format.
+ *
+ * @return bool true if the file was written.
+ */
+bool Tracer::flush() {
+  if (!enabled())
+    return true;
+  std::lock_guard<std::mutex> lock(mutex);
+  FILE* file = fopen(path.c_str(), "w");
+  if (file == nullptr)
+    return false;
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+  for (size_t i = 0; i < events.size(); i++) {
+    const Event& event = events[i];
+    std::string name;
+    for (char c : event.name) {
+      if (c == '"' || c == '\\')
+        name += '\\';
+      if ((unsigned char)c >= 0x20)
+        name += c;
+    }
+    const char* separator = i + 1 < events.size() ? ",\n" : "\n";
+    if (event.phase == 'M') {
+      fprintf(file,
+              "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+              "\"args\":{\"name\":\"%s\"}}%s",
+              event.tid, name.c_str(), separator);
+    } else if (event.phase == 'i') {
+      fprintf(file,
+              "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"p\",\"pid\":1,"
+              "\"tid\":%d,\"ts\":%llu,\"args\":{\"frame\":%llu}}%s",
+              name.c_str(), event.tid, (unsigned long long)event.start,
+              (unsigned long long)event.frame, separator);
+    } else {
+      fprintf(file,
+              "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+              "\"ts\":%llu,\"dur\":%llu,\"args\":{\"frame\":%llu",
+              name.c_str(), event.tid, (unsigned long long)event.start,
+              (unsigned long long)event.duration,
+              (unsigned long long)event.frame);
+      if (event.value != -1)
+        fprintf(file, ",\"value\":%ld", event.value);
+      if (allocTracking())
+        fprintf(file, ",\"allocs\":%llu,\"bytes\":%llu",
+                (unsigned long long)event.allocated.allocations,
+                (unsigned long long)event.allocated.bytes);
+      fprintf(file, "}}%s", separator);
+    }
+  }
+  fputs("]}\n", file);
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
@@ -0,0 +1,662 @@
+/**
+ * @file vm.cpp
+ * @author Devin Arena
+ * @brief Implementation file for the stack virtual machine.
+ * @since 10/19/2026
+ **/
+
+#include "../include/vm.hpp"
+#include "../include/builtins.hpp"
+#include "../include/opcodes.hpp"
+#include "../include/parser.hpp"
+
+#ifdef TG_RDTSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stack>
+
+// without hardware support std::fma is a slow library call, so fall back to a
+// multiply and an add
+#ifdef FP_FAST_FMA
+#define TG_FMA(a, b, c) std::fma(a, b, c)
+#else
+#define TG_FMA(a, b, c) ((a) * (b) + (c))
+#endif
+
+/**
+ * @brief Evaluates a polynomial by Horner's rule for a batch of x values, one
+ * multiply-add per coefficient and lane.
+ *
+ * @param coefficients const Operand* the coefficients, highest degree first.
+ * @param count int the number of coefficients.
+ * @param xs const double* the x values.
+ * @param n size_t the number of x values.
+ * @param out double* receives the value of the polynomial at each x.
+ */
+static void horner(const Operand* coefficients,
+                   int count,
+                   const double* xs,
+                   size_t n,
+                   double* out) {
+  for (size_t k = 0; k < n; k++)
+    out[k] = coefficients[0].value;
+  for (int j = 1; j < count; j++) {
+    double c = coefficients[j].value;
+    for (size_t k = 0; k < n; k++)
+      out[k] = TG_FMA(out[k], xs[k], c);
+  }
+}
+
+/**
+ * @brief Picks one of two values by a condition without branching: the
+ * condition becomes an all ones or all zeros mask which blends the bits of the
+ * two values, so lanes which disagree do not mispredict and the batch loops
+ * can be vectorised. Both values have already been computed.
+ *
+ * @param condition double the condition, true if not 0.
+ * @param a double the value if true.
+ * @param b double the value if false.
+ * @return double a or b.
+ */
+static inline double blend(double condition, double a, double b) {
+  uint64_t mask = -(uint64_t)(condition != 0);
+  uint64_t ba, bb;
+  std::memcpy(&ba, &a, sizeof(double));
+  std::memcpy(&bb, &b, sizeof(double));
+  uint64_t bits = (ba & mask) | (bb & ~mask);
+  double result;
+  std::memcpy(&result, &bits, sizeof(double));
+  return result;
+}
+
+/**
+ * @brief Applies a comparison opcode.
+ *
+ * @param op OP the comparison.
+ * @param b double the left operand.
+ * @param a double the right operand.
+ * @return double 1 if the comparison holds, otherwise 0.
+ */
+static double compare(OP op, double b, double a) {
+  switch (op) {
+    case OP::LESS:
+      return b < a;
+    case OP::LESS_EQUAL:
+      return b <= a;
+    case OP::GREATER:
+      return b > a;
+    case OP::GREATER_EQUAL:
+      return b >= a;
+    case OP::EQUAL:
+      return b == a;
+    case OP::NOT_EQUAL:
+      return b != a;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Default constructor.
+ *
+ * @param env const Environment* parameter values read by PARAM, may be null.
+ * @param cache const std::vector<std::vector<double>>* hoisted values read by
+ * CACHED, may be null.
+ */
+VM::VM(const Environment* env, const std::vector<std::vector<double>>* cache)
+    : env(env), cache(cache), profile(nullptr) {}
+
+/**
+ * @brief Runs a compiled program on the stack virtual machine.
+ *
+ * @param program std::vector<Operand>& the opcodes to run.
+ * @param x double The x value to simulate the program with.
+ * @param column int the screen column of x, for loading hoisted values.
+ * @param y double the y value loaded by VAR_Y.
+ * @return std::vector<double> The y values left on the stack.
+ */
+std::vector<double> VM::run(std::vector<Operand>& program,
+                            double x,
+                            int column,
+                            double y) {
+  std::stack<double> nums;
+#ifdef TG_DEBUG
+  int start = 0;
+#endif
+  std::vector<Operand>& eqOps = program;
+  for (size_t i = 0; i < eqOps.size(); i++) {
+#ifdef TG_DEBUG
+    start = i;
+#endif
+    switch (eqOps[i].opcode) {
+      case OP::CONST: {
+        nums.push(eqOps[++i].value);
+        break;
+      }
+      case OP::VAR: {
+        nums.push(x);
+        break;
+      }
+      case OP::VAR_Y: {
+        nums.push(y);
+        break;
+      }
+      case OP::PARAM: {
+        nums.push(env->getValues()[eqOps[++i].index]);
+        break;
+      }
+      case OP::NEG: {
+        double num = nums.top();
+        nums.pop();
+        nums.push(-num);
+        break;
+      }
+      case OP::ADD: {
+        double a = nums.top();
+        nums.pop();
+        double b = nums.top();
+        nums.pop();
+        nums.push(a + b);
+        break;
+      }
+      case OP::SUB: {
+        double a = nums.top();
+        nums.pop();
+        double b = nums.top();
+        nums.pop();
+        nums.push(b - a);
+        break;
+      }
+      case OP::MUL: {
+        double a = nums.top();
+        nums.pop();
+        double b = nums.top();
+        nums.pop();
+        nums.push(a * b);
+        break;
+      }
+      case OP::DIV: {
+        double a = nums.top();
+        nums.pop();
+        double b = nums.top();
+        nums.pop();
+        if (a == 0)
+          nums.push(INT_MIN);
+        else
+          nums.push(b / a);
+        break;
+      }
+      case OP::POW: {
+        double a = nums.top();
+        nums.pop();
+        double b = nums.top();
+        nums.pop();
+        nums.push(std::pow(b, a));
+        break;
+      }
+      case OP::PLUS_OR_MINUS: {
+        double num = nums.top();
+        nums.push(-num);
+        break;
+      }
+      case OP::MAGIC: {
+        double a = nums.top();
+        nums.pop();
+        if (a > 0) {
+          nums.push(INT_MAX);
+        } else {
+          // INTEGRAL(e^-a^2t) = -1/a^2
+          nums.push(1 / std::pow(a, 2));
+        }
+        break;
+      }
+      case OP::CACHED: {
+        nums.push((*cache)[eqOps[++i].index][column]);
+        break;
+      }
+      case OP::LESS:
+      case OP::LESS_EQUAL:
+      case OP::GREATER:
+      case OP::GREATER_EQUAL:
+      case OP::EQUAL:
+      case OP::NOT_EQUAL: {
+        double a = nums.top();
+        nums.pop();
+        double b = nums.top();
+        nums.pop();
+        nums.push(compare(eqOps[i].opcode, b, a));
+        break;
+      }
+      case OP::SELECT: {
+        double a = nums.top();
+        nums.pop();
+        double b = nums.top();
+        nums.pop();
+        double c = nums.top();
+        nums.pop();
+        nums.push(blend(c, b, a));
+        break;
+      }
+      case OP::POLY: {
+        int num = eqOps[i + 1].index;
+        int den = eqOps[i + 2].index;
+        double y, d = 1;
+        horner(&eqOps[i + 3], num, &x, 1, &y);
+        if (den > 0)
+          horner(&eqOps[i + 3 + num], den, &x, 1, &d);
+        nums.push(d == 0 ? INT_MIN : y / d);
+        i += 2 + num + den;
+        break;
+      }
+      default: {
+        const Builtin* function = builtin(eqOps[i].opcode);
+        if (function == nullptr)
+          break;
+        // the arguments were pushed first to last
+        double args[3];
+        for (int j = function->arity - 1; j >= 0; j--) {
+          args[j] = nums.top();
+          nums.pop();
+        }
+        nums.push(function->scalar(args));
+        break;
+      }
+    }
+#ifdef TG_DEBUG
+    Parser(env).printOP(program, start);
+    std::vector<double> temp;
+    while (!nums.empty()) {
+      temp.push_back(nums.top());
+      nums.pop();
+    }
+    for (int i = temp.size() - 1; i >= 0; i--) {
+      std::cout << "[" << temp[i] << "]";
+      nums.push(temp[i]);
+    }
+    std::cout << "\n";
+#endif
+  }
+  return std::vector<double>(&nums.top() + 1 - nums.size(), &nums.top() + 1);
+}
+
+/**
+ * @brief Gets a batch stack entry, growing the stack if needed.
+ *
+ * @param depth size_t the depth of the entry.
+ * @return double* the VM_BATCH lanes of the entry.
+ */
+double* VM::lane(size_t depth) {
+  if (lanes.size() < (depth + 1) * VM_BATCH)
+    lanes.resize((depth + 1) * VM_BATCH);
+  return lanes.data() + depth * VM_BATCH;
+}
+
+/**
+ * @brief Runs a compiled program over a batch of x values. Every opcode is
+ * applied to all lanes before moving to the next one, so the dispatch cost is
+ * paid once per batch and the inner loops can be vectorized.
+ *
+ * @param program const std::vector<Operand>& the opcodes to run.
+ * @param xs const double* the x values, at most VM_BATCH of them.
+ * @param n size_t the number of x values.
+ * @param out double* receives the results, one row of results() values per x.
+ * @param column int the screen column of xs[0], for loading hoisted values.
+ * @param ys const double* the y values loaded by VAR_Y, one per x, or null
+ * for 0.
+ * @return size_t the number of results per x.
+ */
+size_t VM::runBatch(const std::vector<Operand>& program,
+                    const double* xs,
+                    size_t n,
+                    double* out,
+                    int column,
+                    const double* ys) {
+  size_t depth = 0;
+  if (profile != nullptr) {
+    profile->counts.resize(program.size());
+    profile->cycles.resize(program.size());
+  }
+  for (size_t i = 0; i < program.size(); i++) {
+    size_t start = i;
+    uint64_t began = profile != nullptr ? readCycles() : 0;
+    switch (program[i].opcode) {
+      case OP::CONST: {
+        double v = program[++i].value;
+        double* r = lane(depth++);
+        for (size_t k = 0; k < n; k++)
+          r[k] = v;
+        break;
+      }
+      case OP::VAR: {
+        double* r = lane(depth++);
+        for (size_t k = 0; k < n; k++)
+          r[k] = xs[k];
+        break;
+      }
+      case OP::VAR_Y: {
+        double* r = lane(depth++);
+        for (size_t k = 0; k < n; k++)
+          r[k] = ys != nullptr ? ys[k] : 0;
+        break;
+      }
+      case OP::PARAM: {
+        double v = env->getValues()[program[++i].index];
+        double* r = lane(depth++);
+        for (size_t k = 0; k < n; k++)
+          r[k] = v;
+        break;
+      }
+      case OP::CACHED: {
+        const double* c = (*cache)[program[++i].index].data() + column;
+        double* r = lane(depth++);
+        for (size_t k = 0; k < n; k++)
+          r[k] = c[k];
+        break;
+      }
+      case OP::NEG: {
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          a[k] = -a[k];
+        break;
+      }
+      case OP::ADD: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] + a[k];
+        depth--;
+        break;
+      }
+      case OP::SUB: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] - a[k];
+        depth--;
+        break;
+      }
+      case OP::MUL: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] * a[k];
+        depth--;
+        break;
+      }
+      case OP::DIV: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = a[k] == 0 ? INT_MIN : b[k] / a[k];
+        depth--;
+        break;
+      }
+      case OP::POW: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = std::pow(b[k], a[k]);
+        depth--;
+        break;
+      }
+      case OP::PLUS_OR_MINUS: {
+        double* r = lane(depth);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          r[k] = -a[k];
+        depth++;
+        break;
+      }
+      case OP::MAGIC: {
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          a[k] = a[k] > 0 ? INT_MAX : 1 / (a[k] * a[k]);
+        break;
+      }
+      case OP::LESS: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] < a[k] ? 1.0 : 0.0;
+        depth--;
+        break;
+      }
+      case OP::LESS_EQUAL: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] <= a[k] ? 1.0 : 0.0;
+        depth--;
+        break;
+      }
+      case OP::GREATER: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] > a[k] ? 1.0 : 0.0;
+        depth--;
+        break;
+      }
+      case OP::GREATER_EQUAL: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] >= a[k] ? 1.0 : 0.0;
+        depth--;
+        break;
+      }
+      case OP::EQUAL: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] == a[k] ? 1.0 : 0.0;
+        depth--;
+        break;
+      }
+      case OP::NOT_EQUAL: {
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          b[k] = b[k] != a[k] ? 1.0 : 0.0;
+        depth--;
+        break;
+      }
+      case OP::SELECT: {
+        double* c = lane(depth - 3);
+        double* b = lane(depth - 2);
+        double* a = lane(depth - 1);
+        for (size_t k = 0; k < n; k++)
+          c[k] = blend(c[k], b[k], a[k]);
+        depth -= 2;
+        break;
+      }
+      case OP::POLY: {
+        int num = program[i + 1].index;
+        int den = program[i + 2].index;
+        // the denominator goes in the entry above, which may grow the stack
+        double* d = den > 0 ? lane(depth + 1) : nullptr;
+        double* r = lane(depth++);
+        horner(&program[i + 3], num, xs, n, r);
+        if (den > 0) {
+          horner(&program[i + 3 + num], den, xs, n, d);
+          for (size_t k = 0; k < n; k++)
+            r[k] = d[k] == 0 ? INT_MIN : r[k] / d[k];
+        }
+        i += 2 + num + den;
+        break;
+      }
+      default: {
+        const Builtin* function = builtin(program[i].opcode);
+        if (function == nullptr)
+          break;
+        // the result goes in the lane of the first argument
+        double* args[3];
+        for (int j = 0; j < function->arity; j++)
+          args[j] = lane(depth - function->arity + j);
+        function->vector(args, n);
+        depth -= function->arity - 1;
+        break;
+      }
+    }
+    if (profile != nullptr) {
+      profile->cycles[start] += readCycles() - began;
+      profile->counts[start] += n;
+      profile->maxDepth = std::max(profile->maxDepth, depth);
+    }
+  }
+  // interleave the results so each x has its row of values
+  for (size_t r = 0; r < depth; r++) {
+    const double* a = lanes.data() + r * VM_BATCH;
+    for (size_t k = 0; k < n; k++)
+      out[k * depth + r] = a[k];
+  }
+  return depth;
+}
+
+/**
+ * @brief Starts or stops collecting statistics in runBatch. Timing every
+ * opcode adds some overhead to each, but not to each lane.
+ *
+ * @param profile VMProfile* the statistics to add to, or nullptr to stop.
+ */
+void VM::setProfile(VMProfile* profile) {
+  this->profile = profile;
+}
+
+/**
+ * @brief Gets the memory held by the batch stack.
+ *
+ * @return size_t the size in bytes.
+ */
+size_t VM::footprint() const {
+  return lanes.capacity() * sizeof(double);
+}
+
+/**
+ * @brief Reads the timestamp counter, or a nanosecond clock on processors
+ * without one.
+ *
+ * @return uint64_t the current cycle count.
+ */
+uint64_t VM::readCycles() {
+#ifdef TG_RDTSC
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+/**
+ * @brief Counts the values a program leaves on the stack (more than one when
+ * it uses +/-), without running it.
+ *
+ * @param program const std::vector<Operand>& the program to inspect.
+ * @return size_t the number of results per x.
+ */
+size_t VM::results(const std::vector<Operand>& program) {
+  size_t depth = 0;
+  for (size_t i = 0; i < program.size(); i++) {
+    switch (program[i].opcode) {
+      case OP::CONST:
+      case OP::PARAM:
+      case OP::CACHED:
+        i++;
+        depth++;
+        break;
+      case OP::VAR:
+      case OP::VAR_Y:
+      case OP::PLUS_OR_MINUS:
+        depth++;
+        break;
+      case OP::ADD:
+      case OP::SUB:
+      case OP::MUL:
+      case OP::DIV:
+      case OP::POW:
+      case OP::LESS:
+      case OP::LESS_EQUAL:
+      case OP::GREATER:
+      case OP::GREATER_EQUAL:
+      case OP::EQUAL:
+      case OP::NOT_EQUAL:
+        depth--;
+        break;
+      case OP::SELECT:
+        depth -= 2;
+        break;
+      case OP::POLY:
+        i += 2 + program[i + 1].index + program[i + 2].index;
+        depth++;
+        break;
+      default: {
+        const Builtin* function = builtin(program[i].opcode);
+        if (function != nullptr)
+          depth -= function->arity - 1;
+        break;
+      }
+    }
+  }
+  return depth;
+}
+
+/**
+ * @brief Checks if a program loads a variable.
+ *
+ * @param program const std::vector<Operand>& the program to inspect.
+ * @param variable OP VAR or VAR_Y, POLY counts as loading VAR.
+ * @return bool true if the program loads the variable.
+ */
+static bool loads(const std::vector<Operand>& program, OP variable) {
+  for (size_t i = 0; i < program.size(); i++) {
+    if (program[i].opcode == variable)
+      return true;
+    switch (program[i].opcode) {
+      case OP::CONST:
+      case OP::PARAM:
+      case OP::CACHED:
+        i++;
+        break;
+      case OP::POLY:
+        if (variable == OP::VAR)
+          return true;
+        i += 2 + program[i + 1].index + program[i + 2].index;
+        break;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Checks if a program loads x, i.e. it is not a constant.
+ *
+ * @param program const std::vector<Operand>& the program to inspect.
+ * @return bool true if the program contains VAR or POLY.
+ */
+bool VM::usesX(const std::vector<Operand>& program) {
+  return loads(program, OP::VAR);
+}
+
+/**
+ * @brief Checks if a program loads y, i.e. it is a field f(x, y) rather than a
+ * curve.
+ *
+ * @param program const std::vector<Operand>& the program to inspect.
+ * @return bool true if the program contains VAR_Y.
+ */
+bool VM::usesY(const std::vector<Operand>& program) {
+  return loads(program, OP::VAR_Y);
+}
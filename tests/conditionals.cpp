@@ -0,0 +1,110 @@
+/**
+ * @file conditionals.cpp
+ * @author Devin Arena
+ * @brief Checks comparisons, cond ? a : b (nested and malformed) and the
+ * arity of min, max and clamp, and that the scalar and batched VMs agree on
+ * SELECT.
+ * @since 10/19/2026
+ **/
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+#include "../include/environment.hpp"
+#include "../include/libtgraph.h"
+#include "../include/parser.hpp"
+#include "../include/scanner.hpp"
+#include "../include/vm.hpp"
+
+struct Case {
+  const char* expression;
+  std::function<double(double)> expected;
+};
+
+static const double XS[] = {-2, -1, -0.5, 0, 0.5, 1, 1.5, 2};
+static const int N = sizeof(XS) / sizeof(XS[0]);
+
+/**
+ * @brief Compiles an expression and compares it at every x with its expected
+ * value, evaluated in one batch through the C API and one x at a time by the
+ * scalar VM.
+ *
+ * @param c const Case& the expression and its expected value.
+ * @return int the number of mismatches.
+ */
+static int check(const Case& c) {
+  tg_program* program = tg_compile(c.expression);
+  if (program == NULL) {
+    std::printf("FAIL %s: does not compile\n", c.expression);
+    return 1;
+  }
+  double batched[N];
+  tg_eval(program, XS, 1, batched, 1, N);
+  tg_free(program);
+
+  Environment env;
+  Scanner scanner(&env);
+  Parser parser(&env);
+  std::vector<Token> tokens = scanner.scan(c.expression);
+  std::vector<Operand> ops = parser.parse(tokens);
+  VM vm(&env);
+  int failures = 0;
+  for (int i = 0; i < N; i++) {
+    double expected = c.expected(XS[i]);
+    double scalar = vm.run(ops, XS[i]).front();
+    if (batched[i] != expected || scalar != expected) {
+      std::printf("FAIL %s at x = %g: batched %g, scalar %g, expected %g\n",
+                  c.expression, XS[i], batched[i], scalar, expected);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+/**
+ * @brief Checks the cases that must compile and the ones that must not.
+ *
+ * @return int 0 if every case passed.
+ */
+int main() {
+  const Case cases[] = {
+      {"x < 1", [](double x) { return (double)(x < 1); }},
+      {"x <= 1", [](double x) { return (double)(x <= 1); }},
+      {"x > 0", [](double x) { return (double)(x > 0); }},
+      {"x >= 0", [](double x) { return (double)(x >= 0); }},
+      {"x == 0", [](double x) { return (double)(x == 0); }},
+      {"x != 0", [](double x) { return (double)(x != 0); }},
+      {"x >= 0 ? x : -x", [](double x) { return x >= 0 ? x : -x; }},
+      {"x ? 1 : 2", [](double x) { return x != 0 ? 1.0 : 2.0; }},
+      {"x < 0 ? -1 : x < 1 ? 0 : 1",
+       [](double x) { return x < 0 ? -1.0 : x < 1 ? 0.0 : 1.0; }},
+      {"x > 0 ? (x < 1 ? 5 : 6) : 7",
+       [](double x) { return x > 0 ? (x < 1 ? 5.0 : 6.0) : 7.0; }},
+      {"(x < 1 ? x : 1) * 2", [](double x) { return (x < 1 ? x : 1) * 2; }},
+      {"abs(x)", [](double x) { return std::fabs(x); }},
+      {"min(x, 0)", [](double x) { return std::fmin(x, 0); }},
+      {"max(x, 0)", [](double x) { return std::fmax(x, 0); }},
+      {"clamp(x, -1, 1)",
+       [](double x) { return x < -1 ? -1.0 : x > 1 ? 1.0 : x; }},
+  };
+  const char* invalid[] = {
+      "x > 0 ? 1",   "x > 0 ? 1 2", "min(x)",      "max(x, 1, 2)",
+      "clamp(x, 0)", "abs(x, 1)",   "clamp(x, 0, 1, 2)",
+  };
+  int failures = 0;
+  for (const Case& c : cases) {
+    failures += check(c);
+  }
+  for (const char* expression : invalid) {
+    tg_program* program = tg_compile(expression);
+    if (program != NULL) {
+      std::printf("FAIL %s: compiles\n", expression);
+      tg_free(program);
+      failures++;
+    }
+  }
+  if (failures == 0)
+    std::printf("conditionals: all cases passed\n");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file polynomials.cpp
+ * @author Devin Arena
+ * @brief Checks that polynomials compiled to POLY agree with evaluating them
+ * unexpanded, in particular shifted powers whose expanded coefficients
+ * cancel each other out.
+ * @since 10/19/2026
+ **/
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+#include "../include/libtgraph.h"
+
+struct Case {
+  const char* expression;
+  std::function<double(double)> expected;
+  double xs[5];
+};
+
+/**
+ * @brief Compiles each case and compares it at its x values with the
+ * expression evaluated directly.
+ *
+ * @return int 0 if every case agrees to a relative error of 1e-9.
+ */
+int main() {
+  const Case cases[] = {
+      {"(x-100)^8",
+       [](double x) { return std::pow(x - 100, 8); },
+       {99, 99.5, 100, 100.5, 101}},
+      {"(x-1000)^6",
+       [](double x) { return std::pow(x - 1000, 6); },
+       {999, 999.5, 1000, 1000.5, 1001}},
+      {"(x-1234.5)^5",
+       [](double x) { return std::pow(x - 1234.5, 5); },
+       {1234, 1234.25, 1234.5, 1234.75, 1235}},
+      {"(x-50)*(x-51)*(x-52)",
+       [](double x) { return (x - 50) * (x - 51) * (x - 52); },
+       {50, 50.5, 51, 51.5, 52}},
+      {"3*x^3 - 2*x + 1",
+       [](double x) { return 3 * x * x * x - 2 * x + 1; },
+       {-2, -0.5, 0, 0.5, 2}},
+  };
+  int failures = 0;
+  for (const Case& c : cases) {
+    tg_program* program = tg_compile(c.expression);
+    if (program == NULL) {
+      std::printf("FAIL %s: does not compile\n", c.expression);
+      failures++;
+      continue;
+    }
+    double ys[5];
+    tg_eval(program, c.xs, 1, ys, 1, 5);
+    for (int i = 0; i < 5; i++) {
+      double expected = c.expected(c.xs[i]);
+      double error = std::fabs(ys[i] - expected);
+      if (error > 1e-9 * std::fmax(1.0, std::fabs(expected))) {
+        std::printf("FAIL %s at x = %g: %.17g, expected %.17g\n",
+                    c.expression, c.xs[i], ys[i], expected);
+        failures++;
+      }
+    }
+    tg_free(program);
+  }
+  if (failures == 0)
+    std::printf("polynomials: all cases passed\n");
+  return failures == 0 ? 0 : 1;
+}
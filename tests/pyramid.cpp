@@ -0,0 +1,122 @@
+/**
+ * @file pyramid.cpp
+ * @author Devin Arena
+ * @brief Checks that the min/max pyramid of a dataset gives the same column
+ * ranges as scanning the raw points, for columns whose edges fall inside
+ * pyramid blocks and for empty columns.
+ * @since 10/19/2026
+ **/
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../include/dataset.hpp"
+
+struct View {
+  double left;
+  double step;
+  int width;
+};
+
+/**
+ * @brief Finds the min and max y of the points in each column by scanning
+ * every point.
+ *
+ * @param points const std::vector<double>& the x,y pairs.
+ * @param view const View& the columns.
+ * @param low std::vector<double>& receives the min of each column.
+ * @param high std::vector<double>& receives the max of each column.
+ */
+static void bruteForce(const std::vector<double>& points,
+                       const View& view,
+                       std::vector<double>& low,
+                       std::vector<double>& high) {
+  low.assign(view.width, NAN);
+  high.assign(view.width, NAN);
+  for (int i = 0; i < view.width; i++) {
+    double from = view.left + i * view.step;
+    double to = view.left + (i + 1) * view.step;
+    for (size_t p = 0; p < points.size(); p += 2) {
+      double x = points[p], y = points[p + 1];
+      if (x < from || x >= to)
+        continue;
+      if (std::isnan(low[i]) || y < low[i])
+        low[i] = y;
+      if (std::isnan(high[i]) || y > high[i])
+        high[i] = y;
+    }
+  }
+}
+
+/**
+ * @brief Checks if two column values are equal, NaN equal to NaN.
+ */
+static bool same(double a, double b) {
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+/**
+ * @brief Writes random points with a gap to a raw float64 file, loads it and
+ * compares the columns of several views with a brute force scan.
+ *
+ * @return int 0 if every column agrees.
+ */
+int main() {
+  // irregular x spacing, and a gap wider than a column from 40000 to 41000
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> spacing(0.1, 1.9);
+  std::normal_distribution<double> noise(0, 10);
+  std::vector<double> points;
+  double x = 0;
+  for (int i = 0; i < 100000; i++) {
+    x += spacing(random);
+    if (x > 40000 && x < 41000)
+      x = 41000;
+    points.push_back(x);
+    points.push_back(std::sin(x / 500) * 100 + noise(random));
+  }
+  const char* path = "bin/check_pyramid_points.f64";
+  FILE* file = std::fopen(path, "wb");
+  if (file == NULL ||
+      std::fwrite(points.data(), sizeof(double), points.size(), file) !=
+          points.size()) {
+    std::printf("FAIL could not write %s\n", path);
+    return 1;
+  }
+  std::fclose(file);
+  Dataset dataset;
+  bool loaded = dataset.load(path);
+  std::remove(path);
+  if (!loaded) {
+    std::printf("FAIL could not load the points\n");
+    return 1;
+  }
+
+  // column edges that do not line up with blocks of DATA_BLOCK points, from
+  // a few points per column to many blocks per column
+  const View views[] = {
+      {-10.5, 3.7, 80},     {1234.567, 1000.3, 90}, {39000.25, 97.1, 40},
+      {-5000, 7777.7, 30},  {12345.6, 0.9, 200},    {99990, 13.3, 100},
+  };
+  int failures = 0;
+  for (const View& view : views) {
+    std::vector<double> low(view.width), high(view.width);
+    dataset.columns(view.left, view.step, view.width, low.data(), high.data());
+    std::vector<double> expectedLow, expectedHigh;
+    bruteForce(points, view, expectedLow, expectedHigh);
+    for (int i = 0; i < view.width; i++) {
+      if (!same(low[i], expectedLow[i]) || !same(high[i], expectedHigh[i])) {
+        std::printf("FAIL column %d of left %g step %g: %g..%g, expected "
+                    "%g..%g\n",
+                    i, view.left, view.step, low[i], high[i], expectedLow[i],
+                    expectedHigh[i]);
+        failures++;
+      }
+    }
+  }
+  if (failures == 0)
+    std::printf("pyramid: all cases passed\n");
+  return failures == 0 ? 0 : 1;
+}